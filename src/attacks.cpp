@@ -0,0 +1,130 @@
+#include "attacks.hpp"
+
+constexpr AttackTable Attacks::knightTable;
+constexpr AttackTable Attacks::kingTable;
+constexpr AttackTable Attacks::pawnTables[2];
+
+Attacks::Magic Attacks::bishopMagics[64];
+Attacks::Magic Attacks::rookMagics[64];
+uint64_t Attacks::bishopTable[5248];
+uint64_t Attacks::rookTable[102400];
+uint64_t Attacks::betweenTable[64][64];
+uint64_t Attacks::lineTable[64][64];
+
+// magic multipliers found offline by trial with sparse random numbers, one per square (a1 = 0, h8 = 63)
+const uint64_t Attacks::bishopMagicNumbers[64] = {
+    0x04C4380860440140ULL, 0x002002020A0C2000ULL, 0x8021021400402002ULL, 0x8004242280404200ULL,
+    0x0804030800108200ULL, 0x2001040240080080ULL, 0x0001040104400808ULL, 0x0084808800900444ULL,
+    0x1200100411980200ULL, 0x0000B01080908480ULL, 0x0005088081020090ULL, 0x1091041C21828802ULL,
+    0x0004020210240020ULL, 0x3081011002101580ULL, 0x1500408824100408ULL, 0x2420020100880540ULL,
+    0x0860904002840122ULL, 0x8022003110021082ULL, 0x2042001004001820ULL, 0x4A0800A402102440ULL,
+    0x0884000A00940008ULL, 0x0912006022100200ULL, 0x0411044200822000ULL, 0x0002012101092100ULL,
+    0x00A0840808080800ULL, 0x0204022004080801ULL, 0x1118020001020200ULL, 0x0022008028008002ULL,
+    0x2001001021004000ULL, 0x4000820181004216ULL, 0x00209122008C1000ULL, 0x00C04206A0808400ULL,
+    0x0A01082000082001ULL, 0x0449043088421004ULL, 0x2000180600240C00ULL, 0x000B200800030811ULL,
+    0x80840040101C0100ULL, 0x8012080600204040ULL, 0x0808880040010100ULL, 0x0018309282010040ULL,
+    0x0428040484066080ULL, 0x6202085404500200ULL, 0x2400824240420800ULL, 0x820400D148003400ULL,
+    0x4240200410404C00ULL, 0x081116180A010040ULL, 0x0C60084604A00040ULL, 0x028102020A000049ULL,
+    0x400480842021C040ULL, 0x0002020124421984ULL, 0x4100410088041048ULL, 0x0040800084040400ULL,
+    0x8200011002020416ULL, 0x05480810010A0A11ULL, 0x0010101148428000ULL, 0xA002840802004040ULL,
+    0x0002020622020210ULL, 0x0000228048280401ULL, 0x0102500044041122ULL, 0x4421100400420880ULL,
+    0x2803001C04104414ULL, 0x0002453012108104ULL, 0x0210C00508120441ULL, 0x3040010400820040ULL
+};
+
+const uint64_t Attacks::rookMagicNumbers[64] = {
+    0x8080102040008000ULL, 0x5440041000200048ULL, 0x008020008010000AULL, 0x0200084200100420ULL,
+    0x0200081020040200ULL, 0x0600019002002824ULL, 0x040050811008020CULL, 0x0100004881000126ULL,
+    0x0005800440008020ULL, 0x2882002042090880ULL, 0x0002802000801004ULL, 0x0240808010000800ULL,
+    0x4480800800040082ULL, 0x0408808004000200ULL, 0x00BA0004A8020001ULL, 0x1106000042040091ULL,
+    0x0020208010400080ULL, 0x0022060045028020ULL, 0x0020008020100080ULL, 0x0202020008102041ULL,
+    0x0C50808008000400ULL, 0x0068808002000400ULL, 0x00510400C8100201ULL, 0x400006000100A444ULL,
+    0x483424818008400AULL, 0x8840008080200040ULL, 0x0800100080802000ULL, 0x0440100080800800ULL,
+    0x4000080080040080ULL, 0x9124040080020080ULL, 0x0089000300040E00ULL, 0x080001020020488CULL,
+    0x9040002040800080ULL, 0x80D0002001400242ULL, 0x0000401901002002ULL, 0x0030220901001000ULL,
+    0x0080580005003100ULL, 0x0022006C0A001008ULL, 0x0802301144001248ULL, 0x0020010042000084ULL,
+    0x4AC0400084228004ULL, 0x0010004020004000ULL, 0x3110004020010100ULL, 0x0598100009050020ULL,
+    0x4200080011010004ULL, 0x0818020004008080ULL, 0x02A0708102040008ULL, 0x5201010080420004ULL,
+    0x100B124063800100ULL, 0x7808200240048980ULL, 0x8800200010008080ULL, 0x1099201001000900ULL,
+    0x0100050010080100ULL, 0x0400800200040080ULL, 0x2040280190020400ULL, 0x00100C0100608200ULL,
+    0x0000201241088202ULL, 0x1040002042801B01ULL, 0x0124090010200041ULL, 0x0831002004081001ULL,
+    0x2003000800021005ULL, 0x80010002040008C1ULL, 0x0208008122081004ULL, 0x4000008844002102ULL
+};
+
+const bool Attacks::initialized = Attacks::initialize();
+
+bool Attacks::initialize() {
+    static const int bishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    static const int rookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+    initializeSlider(bishopMagics, bishopTable, bishopMagicNumbers, bishopDirections);
+    initializeSlider(rookMagics, rookTable, rookMagicNumbers, rookDirections);
+
+    // lines and in-between squares follow from the slider attacks on an empty board
+    for (int from = 0; from < 64; ++from) {
+        for (int to = 0; to < 64; ++to) {
+            if (from == to) {
+                continue;
+            }
+
+            uint64_t fromBit = 1ULL << from;
+            uint64_t toBit = 1ULL << to;
+            if (rookAttacks(from, 0) & toBit) {
+                lineTable[from][to] = (rookAttacks(from, 0) & rookAttacks(to, 0)) | fromBit | toBit;
+                betweenTable[from][to] = rookAttacks(from, toBit) & rookAttacks(to, fromBit);
+            } else if (bishopAttacks(from, 0) & toBit) {
+                lineTable[from][to] = (bishopAttacks(from, 0) & bishopAttacks(to, 0)) | fromBit | toBit;
+                betweenTable[from][to] = bishopAttacks(from, toBit) & bishopAttacks(to, fromBit);
+            }
+        }
+    }
+    return true;
+}
+
+void Attacks::initializeSlider(Magic magics[64], uint64_t* table, const uint64_t magicNumbers[64], const int directions[4][2]) {
+    uint64_t* slice = table;
+
+    for (int square = 0; square < 64; ++square) {
+        Magic& m = magics[square];
+        m.mask = slidingAttacks(square, 0, directions, true);
+        m.magic = magicNumbers[square];
+        m.shift = 64 - __builtin_popcountll(m.mask);
+        m.attacks = slice;
+
+        // enumerate every subset of the relevant occupancy (Carry-Rippler trick) and store its attack set
+        uint64_t subset = 0;
+        do {
+            m.attacks[m.index(subset)] = slidingAttacks(square, subset, directions, false);
+            subset = (subset - m.mask) & m.mask;
+        } while (subset);
+
+        slice += 1ULL << __builtin_popcountll(m.mask);
+    }
+}
+
+uint64_t Attacks::slidingAttacks(int square, uint64_t occupied, const int directions[4][2], bool excludeEdges) {
+    uint64_t attacks = 0;
+
+    for (int i = 0; i < 4; ++i) {
+        int rank = square / 8 + directions[i][0];
+        int file = square % 8 + directions[i][1];
+
+        while (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+            int nextRank = rank + directions[i][0];
+            int nextFile = file + directions[i][1];
+            if (excludeEdges && (nextRank < 0 || nextRank > 7 || nextFile < 0 || nextFile > 7)) {
+                break;
+            }
+
+            uint64_t bit = 1ULL << (rank * 8 + file);
+            attacks |= bit;
+            if (occupied & bit) {
+                break;
+            }
+
+            rank = nextRank;
+            file = nextFile;
+        }
+    }
+
+    return attacks;
+}
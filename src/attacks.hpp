@@ -0,0 +1,208 @@
+#ifndef ATTACKS_HPP
+#define ATTACKS_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Attack bitboards for a non-sliding piece, one per square. Built entirely at compile time.
+ */
+struct AttackTable {
+    uint64_t squares[64];
+
+    /**
+     * @brief Builds the knight attack table.
+     * @return The table of knight attacks.
+     */
+    static constexpr AttackTable knight() {
+        const int deltas[8][2] = {{2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}};
+        return leaper(deltas, 8);
+    }
+
+    /**
+     * @brief Builds the king attack table.
+     * @return The table of king attacks.
+     */
+    static constexpr AttackTable king() {
+        const int deltas[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+        return leaper(deltas, 8);
+    }
+
+    /**
+     * @brief Builds the pawn capture table for the given player.
+     * @param player The player owning the pawns (0 for white, 1 for black).
+     * @return The table of squares attacked diagonally forward by a pawn.
+     */
+    static constexpr AttackTable pawn(int player) {
+        const int deltas[2][2] = {{player == 0 ? 1 : -1, 1}, {player == 0 ? 1 : -1, -1}};
+        return leaper(deltas, 2);
+    }
+
+private:
+    /**
+     * @brief Builds a table from a list of {rank delta, file delta} jumps, dropping jumps that leave the board.
+     * @param deltas The jumps.
+     * @param count The number of jumps.
+     * @return The table of attacks.
+     */
+    static constexpr AttackTable leaper(const int deltas[][2], int count) {
+        AttackTable table{};
+        for (int square = 0; square < 64; ++square) {
+            for (int i = 0; i < count; ++i) {
+                int rank = square / 8 + deltas[i][0];
+                int file = square % 8 + deltas[i][1];
+                if (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+                    table.squares[square] |= 1ULL << (rank * 8 + file);
+                }
+            }
+        }
+        return table;
+    }
+};
+
+/**
+ * @class Attacks
+ * @brief Precomputed attack tables. Knights, kings and pawn captures come from tables generated at compile time.
+ * Sliding pieces (bishops, rooks, queens) are looked up through magic bitboards, so the full attack set of a slider
+ * on a given occupancy costs a single multiplication and a table load.
+ */
+class Attacks {
+public:
+    /**
+     * @brief Gets the squares attacked by a knight.
+     * @param square The square index (0-63) of the knight.
+     * @return The bitboard of attacked squares.
+     */
+    static constexpr uint64_t knightAttacks(int square) { return knightTable.squares[square]; }
+
+    /**
+     * @brief Gets the squares attacked by a king.
+     * @param square The square index (0-63) of the king.
+     * @return The bitboard of attacked squares.
+     */
+    static constexpr uint64_t kingAttacks(int square) { return kingTable.squares[square]; }
+
+    /**
+     * @brief Gets the squares attacked by a pawn (captures only, pushes are not attacks).
+     * @param player The player owning the pawn (0 for white, 1 for black).
+     * @param square The square index (0-63) of the pawn.
+     * @return The bitboard of attacked squares.
+     */
+    static constexpr uint64_t pawnAttacks(int player, int square) { return pawnTables[player].squares[square]; }
+
+    /**
+     * @brief Gets the squares attacked by a bishop.
+     * @param square The square index (0-63) of the bishop.
+     * @param occupied The bitboard representing all occupied squares.
+     * @return The bitboard of attacked squares, including the first blocker in each direction.
+     */
+    static uint64_t bishopAttacks(int square, uint64_t occupied);
+
+    /**
+     * @brief Gets the squares attacked by a rook.
+     * @param square The square index (0-63) of the rook.
+     * @param occupied The bitboard representing all occupied squares.
+     * @return The bitboard of attacked squares, including the first blocker in each direction.
+     */
+    static uint64_t rookAttacks(int square, uint64_t occupied);
+
+    /**
+     * @brief Gets the squares attacked by a queen.
+     * @param square The square index (0-63) of the queen.
+     * @param occupied The bitboard representing all occupied squares.
+     * @return The bitboard of attacked squares, including the first blocker in each direction.
+     */
+    static uint64_t queenAttacks(int square, uint64_t occupied);
+
+    /**
+     * @brief Gets the squares strictly between two squares on a shared rank, file or diagonal.
+     * @param from The first square index (0-63).
+     * @param to The second square index (0-63).
+     * @return The bitboard of squares in between, or 0 if the squares are not aligned.
+     */
+    static uint64_t between(int from, int to) { return betweenTable[from][to]; }
+
+    /**
+     * @brief Gets the full line (rank, file or diagonal) through two squares, edge to edge.
+     * @param from The first square index (0-63).
+     * @param to The second square index (0-63).
+     * @return The bitboard of the line, or 0 if the squares are not aligned.
+     */
+    static uint64_t line(int from, int to) { return lineTable[from][to]; }
+
+private:
+    static constexpr AttackTable knightTable = AttackTable::knight();
+    static constexpr AttackTable kingTable = AttackTable::king();
+    static constexpr AttackTable pawnTables[2] = {AttackTable::pawn(0), AttackTable::pawn(1)};
+
+    /**
+     * @brief Magic lookup entry for a single square.
+     */
+    struct Magic {
+        uint64_t mask;      // relevant occupancy bits (board edges excluded)
+        uint64_t magic;     // multiplier mapping each relevant occupancy to a unique index
+        uint64_t* attacks;  // start of this square's slice of the shared attack table
+        int shift;          // 64 minus the number of relevant bits
+
+        /**
+         * @brief Computes the attack table index for the given occupancy.
+         * @param occupied The bitboard representing all occupied squares.
+         * @return The index into this square's attack slice.
+         */
+        unsigned index(uint64_t occupied) const {
+            return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+        }
+    };
+
+    /**
+     * @brief Fills the magic entries and the shared attack tables. Runs once during static initialization.
+     * @return Always true, so the result can initialize a static flag.
+     */
+    static bool initialize();
+
+    /**
+     * @brief Fills the magic entries and attack table slices for one slider type.
+     * @param magics The magic entries to fill.
+     * @param table The shared attack table for this slider type.
+     * @param magicNumbers The precomputed magic multipliers, one per square.
+     * @param directions The four ray directions as {rank delta, file delta} pairs.
+     */
+    static void initializeSlider(Magic magics[64], uint64_t* table, const uint64_t magicNumbers[64], const int directions[4][2]);
+
+    /**
+     * @brief Computes slider attacks by walking the rays. Only used to fill the tables.
+     * @param square The square index (0-63) of the slider.
+     * @param occupied The bitboard representing all occupied squares.
+     * @param directions The four ray directions as {rank delta, file delta} pairs.
+     * @param excludeEdges Whether to stop before the last square of every ray (used to build relevant occupancy masks).
+     * @return The bitboard of attacked squares.
+     */
+    static uint64_t slidingAttacks(int square, uint64_t occupied, const int directions[4][2], bool excludeEdges);
+
+    static Magic bishopMagics[64];
+    static Magic rookMagics[64];
+    static uint64_t bishopTable[5248];
+    static uint64_t rookTable[102400];
+
+    static uint64_t betweenTable[64][64];
+    static uint64_t lineTable[64][64];
+
+    static const uint64_t bishopMagicNumbers[64];
+    static const uint64_t rookMagicNumbers[64];
+    static const bool initialized;
+};
+
+inline uint64_t Attacks::bishopAttacks(int square, uint64_t occupied) {
+    const Magic& m = bishopMagics[square];
+    return m.attacks[m.index(occupied)];
+}
+
+inline uint64_t Attacks::rookAttacks(int square, uint64_t occupied) {
+    const Magic& m = rookMagics[square];
+    return m.attacks[m.index(occupied)];
+}
+
+inline uint64_t Attacks::queenAttacks(int square, uint64_t occupied) {
+    return bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+}
+
+#endif // ATTACKS_HPP
@@ -1,23 +1,31 @@
 #include "chessengine.hpp"
+#include "evaluation.hpp"
 #include "movevalidator.hpp"
 #include "moveexecutor.hpp"
 #include "utils.hpp"
+#include "perft.hpp"
+#include "search.hpp"
+#include "transpositiontable.hpp"
+#include "zobrist.hpp"
 #include <iostream>
 #include <bitset>
 #include <ctime>
 #include <climits>
-#include <random>
 #include <fstream>
-#include <chrono>
+#include <sstream>
+#include <algorithm>
+
+const int ChessEngine::historySize;
 
 void ChessEngine::saveGameToFile(const std::string& path, int currentPlayer) const {
     std::ofstream file(path);
     if (file.is_open()) {
         // save board state
-        file << whitePawns << ' ' << whiteKnights << ' ' << whiteBishops << ' ' << whiteRooks << ' '
-             << whiteQueens << ' ' << whiteKing << '\n';
-        file << blackPawns << ' ' << blackKnights << ' ' << blackBishops << ' ' << blackRooks << ' '
-             << blackQueens << ' ' << blackKing << '\n';
+        for (int player = 0; player < 2; ++player) {
+            for (int type = PAWN; type <= KING; ++type) {
+                file << bitboards[player][type] << (type == KING ? '\n' : ' ');
+            }
+        }
 
         // save castling flags
         file << whiteKingMoved << ' ' << whiteRookA1Moved << ' ' << whiteRookH1Moved << ' '
@@ -29,10 +37,11 @@ void ChessEngine::saveGameToFile(const std::string& path, int currentPlayer) con
         // save half-move clock
         file << halfMoveClock << '\n';
 
-        // save position history
-        file << positionList.size() << '\n';
-        for (const auto& hash : positionList) {
-            file << hash << ' ';
+        // save position history, back to the last capture or pawn move
+        int historyLength = std::min(historyCount, std::min(halfMoveClock + 1, historySize));
+        file << historyLength << '\n';
+        for (int ply = historyCount - historyLength; ply < historyCount; ++ply) {
+            file << positionHistory[ply & (historySize - 1)] << ' ';
         }
         file << '\n';
 
@@ -42,25 +51,8 @@ void ChessEngine::saveGameToFile(const std::string& path, int currentPlayer) con
         // save the player types
         file << static_cast<int>(whitePlayerType) << ' ' << static_cast<int>(blackPlayerType) << '\n';
 
-        // save the Zobrist table
-        for (int piece = 0; piece < 12; ++piece) {
-            for (int square = 0; square < 64; ++square) {
-                file << zobristTable[piece][square] << ' ';
-            }
-            file << '\n';
-        }
-        for (int i = 0; i < 4; ++i) {
-            file << zobristCastle[i] << ' ';
-        }
-        file << '\n';
-        for (int i = 0; i < 8; ++i) {
-            file << zobristEnPassant[i] << ' ';
-        }
-        file << '\n';
-        file << zobristSide << '\n';
-
         // save the current game status
-        file << static_cast<int>(status) << '\n';
+        file << static_cast<int>(getGameStatus()) << '\n';
 
         file.close();
     }
@@ -73,8 +65,12 @@ void ChessEngine::loadGameFromFile(const std::string& path, bool isEval) {
         // load board state
         int player; 
 
-        file >> whitePawns >> whiteKnights >> whiteBishops >> whiteRooks >> whiteQueens >> whiteKing;
-        file >> blackPawns >> blackKnights >> blackBishops >> blackRooks >> blackQueens >> blackKing;
+        for (int side = 0; side < 2; ++side) {
+            for (int type = PAWN; type <= KING; ++type) {
+                file >> bitboards[side][type];
+            }
+        }
+        updateMailboxAndOccupancy();
 
         // load castling flags
         file >> whiteKingMoved >> whiteRookA1Moved >> whiteRookH1Moved;
@@ -87,15 +83,12 @@ void ChessEngine::loadGameFromFile(const std::string& path, bool isEval) {
         file >> halfMoveClock;
 
         // load position history
-        size_t positionListSize;
-        file >> positionListSize;
-        positionHistory.clear();
-        positionList.clear();
-        for (size_t i = 0; i < positionListSize; ++i) {
-            uint64_t hash;
-            file >> hash;
-            positionList.push_back(hash);
-            positionHistory[hash]++;
+        size_t historyLength;
+        file >> historyLength;
+        historyCount = 0;
+        for (size_t i = 0; i < historyLength; ++i) {
+            file >> positionHistory[historyCount & (historySize - 1)];
+            ++historyCount;
         }
 
         // load the current player
@@ -107,37 +100,31 @@ void ChessEngine::loadGameFromFile(const std::string& path, bool isEval) {
         whitePlayerType = static_cast<PlayerType>(whitePlayerTypeInt);
         blackPlayerType = static_cast<PlayerType>(blackPlayerTypeInt);
 
-        // load the Zobrist table
-        for (int piece = 0; piece < 12; ++piece) {
-            for (int square = 0; square < 64; ++square) {
-                file >> zobristTable[piece][square];
-            }
-        }
-        for (int i = 0; i < 4; ++i) {
-            file >> zobristCastle[i];
-        }
-        for (int i = 0; i < 8; ++i) {
-            file >> zobristEnPassant[i];
-        }
-        file >> zobristSide;
+        // the hash of the loaded position
+        sideToMove = player;
+        hash = calculateZobristHash();
 
         // load the current game status
         int statusInt;
         file >> statusInt;
         status = static_cast<GameStatus>(statusInt);
+        statusKnown = true;
 
         file.close();
 
-        std::cout << "Game has been loaded from file." << std::endl;
-        Utils::printBoard(*this);
+        if (!isHeadless()) {
+            std::cout << "Game has been loaded from file." << std::endl;
+            Utils::printBoard(*this);
+        }
         
         if (!isEval) {
-            while (status == GameStatus::IN_PROGRESS) {
+            while (getGameStatus() == GameStatus::IN_PROGRESS) {
                 playerMove(player);
-                status = getGameStatus();
-                std::cout << "Game status: " << status << std::endl;
                 player = 1 - player;
-                Utils::printBoard(*this);
+                if (!isHeadless()) {
+                    std::cout << "Game status: " << getGameStatus() << std::endl;
+                    Utils::printBoard(*this);
+                }
             }
         }
     }
@@ -146,6 +133,87 @@ void ChessEngine::loadGameFromFile(const std::string& path, bool isEval) {
     }
 }
 
+int ChessEngine::loadFEN(const std::string& fen) {
+    std::istringstream stream(fen);
+    std::string placement, side, castling, enPassant;
+    int halfMoves = 0;
+    if (!(stream >> placement >> side >> castling >> enPassant)) {
+        throw std::invalid_argument("Invalid FEN: missing fields");
+    }
+    stream >> halfMoves; // optional, as is the full-move number after it
+
+    // piece placement, from rank 8 down to rank 1
+    const std::string pieceChars = "PNBRQKpnbrqk";
+    for (int player = 0; player < 2; ++player) {
+        for (int type = PAWN; type <= KING; ++type) {
+            bitboards[player][type] = 0;
+        }
+    }
+
+    int rank = 7;
+    int file = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            if (file != 8 || rank == 0) {
+                throw std::invalid_argument("Invalid FEN: bad rank length");
+            }
+            --rank;
+            file = 0;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+        } else if (pieceChars.find(c) != std::string::npos && file < 8) {
+            int piece = static_cast<int>(pieceChars.find(c));
+            bitboards[piece / 6][piece % 6] |= 1ULL << (rank * 8 + file);
+            ++file;
+        } else {
+            throw std::invalid_argument("Invalid FEN: bad piece placement");
+        }
+        if (file > 8) {
+            throw std::invalid_argument("Invalid FEN: bad rank length");
+        }
+    }
+    if (rank != 0 || file != 8 || __builtin_popcountll(bitboards[0][KING]) != 1 || __builtin_popcountll(bitboards[1][KING]) != 1) {
+        throw std::invalid_argument("Invalid FEN: bad piece placement");
+    }
+    updateMailboxAndOccupancy();
+
+    if (side != "w" && side != "b") {
+        throw std::invalid_argument("Invalid FEN: bad side to move");
+    }
+
+    // castling rights map onto the moved flags: a right is kept while neither the king nor that rook has moved
+    bool whiteKingside = castling.find('K') != std::string::npos;
+    bool whiteQueenside = castling.find('Q') != std::string::npos;
+    bool blackKingside = castling.find('k') != std::string::npos;
+    bool blackQueenside = castling.find('q') != std::string::npos;
+    whiteKingMoved = !whiteKingside && !whiteQueenside;
+    whiteRookH1Moved = !whiteKingside;
+    whiteRookA1Moved = !whiteQueenside;
+    blackKingMoved = !blackKingside && !blackQueenside;
+    blackRookH8Moved = !blackKingside;
+    blackRookA8Moved = !blackQueenside;
+
+    if (enPassant == "-") {
+        enPassantTarget = -1;
+    } else {
+        enPassantTarget = enPassant.length() == 2 ? PackedMove::parseSquare(enPassant.data()) : -1;
+        if (enPassantTarget < 0) {
+            throw std::invalid_argument("Invalid FEN: bad en passant square");
+        }
+    }
+
+    halfMoveClock = halfMoves;
+    status = GameStatus::IN_PROGRESS;
+    statusKnown = false;
+    sideToMove = side == "w" ? 0 : 1;
+    hash = calculateZobristHash();
+
+    historyCount = 0;
+    recordPosition();
+
+    return side == "w" ? 0 : 1;
+}
+
 std::ostream& operator<<(std::ostream& os, const GameStatus& status) {
     switch (status) {
         case GameStatus::IN_PROGRESS:
@@ -185,119 +253,114 @@ std::ostream& operator<<(std::ostream& os, const GameStatus& status) {
     return os;
 }
 
-ChessEngine::ChessEngine() {
-    initializeZobristTable();
+ChessEngine::ChessEngine()
+    : hashMegabytes(64), searchThreads(1), pinThreads(false), headless(false), random(std::time(nullptr)) {
+    searchLimits.depth = 4;
     newGame();
-    std::srand(std::time(nullptr)); // seed
 }
 
 void ChessEngine::newGame() {
-    whitePawns = 0x000000000000FF00;
-    whiteKnights = 0x0000000000000042;
-    whiteBishops = 0x0000000000000024;
-    whiteRooks = 0x0000000000000081;
-    whiteQueens = 0x0000000000000008;
-    whiteKing = 0x0000000000000010;
-    blackPawns = 0x00FF000000000000;
-    blackKnights = 0x4200000000000000;
-    blackBishops = 0x2400000000000000;
-    blackRooks = 0x8100000000000000;
-    blackQueens = 0x0800000000000000;
-    blackKing = 0x1000000000000000;
+    bitboards[0][PAWN] = 0x000000000000FF00;
+    bitboards[0][KNIGHT] = 0x0000000000000042;
+    bitboards[0][BISHOP] = 0x0000000000000024;
+    bitboards[0][ROOK] = 0x0000000000000081;
+    bitboards[0][QUEEN] = 0x0000000000000008;
+    bitboards[0][KING] = 0x0000000000000010;
+    bitboards[1][PAWN] = 0x00FF000000000000;
+    bitboards[1][KNIGHT] = 0x4200000000000000;
+    bitboards[1][BISHOP] = 0x2400000000000000;
+    bitboards[1][ROOK] = 0x8100000000000000;
+    bitboards[1][QUEEN] = 0x0800000000000000;
+    bitboards[1][KING] = 0x1000000000000000;
+    updateMailboxAndOccupancy();
 
     whiteKingMoved = whiteRookA1Moved = whiteRookH1Moved = false;
     blackKingMoved = blackRookA8Moved = blackRookH8Moved = false;
 
     enPassantTarget = -1;
+    sideToMove = 0;
 
     status = GameStatus::IN_PROGRESS;
-
-    // clear the position history
-    positionHistory.clear();
-    positionList.clear();
-
-    // hash for the initial position
-    uint64_t hash = calculateZobristHash();
-    positionHistory[hash] = 1;
-    positionList.push_back(hash);
+    statusKnown = true;
 
     halfMoveClock = 0;
+
+    // hash for the initial position, which starts the position history
+    hash = calculateZobristHash();
+    historyCount = 0;
+    recordPosition();
 }
 
-void ChessEngine::initializeZobristTable() {
-    std::mt19937_64 rng(std::chrono::steady_clock::now().time_since_epoch().count());
+uint64_t ChessEngine::calculateZobristHash() const {
+    uint64_t hash = 0;
 
-    // Zobrist table init for pieces
+    // pieces
     for (int piece = 0; piece < 12; ++piece) {
-        for (int square = 0; square < 64; ++square) {
-            zobristTable[piece][square] = rng();
+        for (uint64_t bitboard = bitboards[piece / 6][piece % 6]; bitboard; bitboard &= bitboard - 1) {
+            hash ^= Zobrist::piece(piece, __builtin_ctzll(bitboard));
         }
     }
 
-    // Zobrist table init for castling rights
-    for (int i = 0; i < 4; ++i) {
-        zobristCastle[i] = rng();
-    }
+    // castling rights and en passant target
+    hash ^= castlingHash() ^ enPassantHash();
 
-    // Zobrist table init for en passant targets
-    for (int i = 0; i < 8; ++i) {
-        zobristEnPassant[i] = rng();
+    // side to move
+    if (sideToMove == 1) {
+        hash ^= Zobrist::side();
     }
 
-    // Zobrist table init for the side to move
-    zobristSide = rng();
+    return hash;
 }
 
-uint64_t ChessEngine::calculateZobristHash() const {
-    uint64_t hash = 0;
-
-    // pieces
+void ChessEngine::updateMailboxAndOccupancy() {
     for (int square = 0; square < 64; ++square) {
-        if (whitePawns & (1ULL << square)) hash ^= zobristTable[0][square];
-        if (whiteKnights & (1ULL << square)) hash ^= zobristTable[1][square];
-        if (whiteBishops & (1ULL << square)) hash ^= zobristTable[2][square];
-        if (whiteRooks & (1ULL << square)) hash ^= zobristTable[3][square];
-        if (whiteQueens & (1ULL << square)) hash ^= zobristTable[4][square];
-        if (whiteKing & (1ULL << square)) hash ^= zobristTable[5][square];
-
-        if (blackPawns & (1ULL << square)) hash ^= zobristTable[6][square];
-        if (blackKnights & (1ULL << square)) hash ^= zobristTable[7][square];
-        if (blackBishops & (1ULL << square)) hash ^= zobristTable[8][square];
-        if (blackRooks & (1ULL << square)) hash ^= zobristTable[9][square];
-        if (blackQueens & (1ULL << square)) hash ^= zobristTable[10][square];
-        if (blackKing & (1ULL << square)) hash ^= zobristTable[11][square];
-    }
-
-    // castling rights
-    if (!whiteKingMoved) {
-        if (!whiteRookA1Moved) hash ^= zobristCastle[0];
-        if (!whiteRookH1Moved) hash ^= zobristCastle[1];
+        pieceOn[square] = -1;
     }
-    if (!blackKingMoved) {
-        if (!blackRookA8Moved) hash ^= zobristCastle[2];
-        if (!blackRookH8Moved) hash ^= zobristCastle[3];
+    occupancy[WHITE] = occupancy[BLACK] = 0;
+    for (int piece = 0; piece < 12; ++piece) {
+        occupancy[piece / 6] |= bitboards[piece / 6][piece % 6];
+        for (uint64_t bitboard = bitboards[piece / 6][piece % 6]; bitboard; bitboard &= bitboard - 1) {
+            pieceOn[__builtin_ctzll(bitboard)] = static_cast<int8_t>(piece);
+        }
     }
+    occupancy[ALL] = occupancy[WHITE] | occupancy[BLACK];
+    Evaluation::computeScores(*this, middlegameScore, endgameScore, gamePhase);
+}
 
-    // en passant target
-    if (enPassantTarget != -1) {
-        hash ^= zobristEnPassant[enPassantTarget % 8];
+uint64_t ChessEngine::castlingHash() const {
+    uint64_t hash = 0;
+    if (!whiteKingMoved) {
+        if (!whiteRookA1Moved) hash ^= Zobrist::castling(0);
+        if (!whiteRookH1Moved) hash ^= Zobrist::castling(1);
+    }
+    if (!blackKingMoved) {
+        if (!blackRookA8Moved) hash ^= Zobrist::castling(2);
+        if (!blackRookH8Moved) hash ^= Zobrist::castling(3);
     }
-
-    // side to move
-    hash ^= zobristSide;
-
     return hash;
 }
 
+uint64_t ChessEngine::enPassantHash() const {
+    return enPassantTarget != -1 ? Zobrist::enPassant(enPassantTarget % 8) : 0;
+}
+
 bool ChessEngine::isRepetitionDraw() const {
-    for (const auto& entry : positionHistory) {
-        if (entry.second >= 3) {
+    // step back two plies at a time (same side to move) until the last irreversible move
+    int window = std::min(halfMoveClock, std::min(historyCount, historySize) - 1);
+    int repetitions = 1;
+    for (int back = 2; back <= window; back += 2) {
+        if (positionHistory[(historyCount - 1 - back) & (historySize - 1)] == hash && ++repetitions >= 3) {
             return true;
         }
     }
     return false;
 }
 
+void ChessEngine::recordPosition() {
+    positionHistory[historyCount & (historySize - 1)] = hash;
+    ++historyCount;
+}
+
 void ChessEngine::startGame(GameMode mode) {
     newGame();
 
@@ -314,17 +377,28 @@ void ChessEngine::startGame(GameMode mode) {
             whitePlayerType = PlayerType::GREEDY_AI; // or RANDOM_AI
             blackPlayerType = PlayerType::RANDOM_AI; // or GREEDY_AI
             break;
+        case GameMode::HUMAN_VS_SEARCH:
+            whitePlayerType = PlayerType::HUMAN;
+            blackPlayerType = PlayerType::SEARCH_AI;
+            break;
+        case GameMode::SEARCH_VS_SEARCH:
+            whitePlayerType = PlayerType::SEARCH_AI;
+            blackPlayerType = PlayerType::SEARCH_AI;
+            break;
     }
 
     int player = 0;
-    Utils::printBoard(*this);
+    if (!isHeadless()) {
+        Utils::printBoard(*this);
+    }
 
-    while (status == GameStatus::IN_PROGRESS) {
+    while (getGameStatus() == GameStatus::IN_PROGRESS) {
         playerMove(player);
-        status = getGameStatus();
-        std::cout << "Game status: " << status << std::endl;
         player = 1 - player;
-        Utils::printBoard(*this);
+        if (!isHeadless()) {
+            std::cout << "Game status: " << getGameStatus() << std::endl;
+            Utils::printBoard(*this);
+        }
     }    
 }
 
@@ -334,6 +408,7 @@ void ChessEngine::handleResignation(int player) {
     } else {
         status = GameStatus::BLACK_RESIGNS;
     }
+    statusKnown = true;
 }
 
 std::string ChessEngine::askForMove(int player) {
@@ -373,6 +448,7 @@ bool ChessEngine::handleDrawAgreement(int player) {
     std::cin >> response;
     if (response == "yes") {
         status = GameStatus::DRAW_AGREEMENT;
+        statusKnown = true;
         return true;
     }
 
@@ -432,126 +508,135 @@ void ChessEngine::playerMove(int player) {
         makeHumanMove(player);
     } else if ((player == 0 && whitePlayerType == PlayerType::RANDOM_AI) || (player == 1 && blackPlayerType == PlayerType::RANDOM_AI)) {
         makeRandomMove(player);
+    } else if ((player == 0 && whitePlayerType == PlayerType::SEARCH_AI) || (player == 1 && blackPlayerType == PlayerType::SEARCH_AI)) {
+        makeSearchMove(player);
     } else {
         makeGreedyMove(player);
     }
 }
 
 void ChessEngine::makeRandomMove(int player) {
-    std::vector<Move> validMoves = MoveGenerator::generateAllValidMoves(*this, player);
+    MoveList validMoves;
+    MoveGenerator::generateAllValidMoves(*this, player, validMoves);
     if (validMoves.empty()) {
         throw std::runtime_error("No valid moves available.");
     }
-    int randomIndex = std::rand() % validMoves.size();
-    Move randomMove = validMoves[randomIndex];
+    int randomIndex = std::uniform_int_distribution<int>(0, validMoves.size() - 1)(random);
+    PackedMove randomMove = validMoves[randomIndex];
     makeMove(randomMove, player);
 }
 
 void ChessEngine::makeGreedyMove(int player) {
-    std::vector<Move> validMoves = MoveGenerator::generateAllValidMoves(*this, player);
+    MoveList validMoves;
+    MoveGenerator::generateAllValidMoves(*this, player, validMoves);
     if (validMoves.empty()) {
         throw std::runtime_error("No valid moves available.");
     }
 
     int bestScore = (player == 0) ? INT_MIN : INT_MAX;
-
-    // first, find the best score, then create a list of moves with the best score, then choose a random move from that list
-    for (const Move& move : validMoves) {
-        ChessEngine hypotheticalEngine = *this;
-        MoveExecutor::makeMove(hypotheticalEngine, move, player);
-        int score = Utils::evaluateBoard(hypotheticalEngine, player);
-
-        if ((player == 0 && score > bestScore) || (player == 1 && score < bestScore)) {
-            bestScore = score;
+    int scores[MoveList::capacity];
+
+    // first, score every move in place for white, which white maximises and black minimises, and find the best score,
+    // then choose a random move among those with the best score
+    for (int i = 0; i < validMoves.size(); ++i) {
+        UndoRecord undo;
+        MoveExecutor::makeMove(*this, validMoves[i], player, undo);
+        scores[i] = Utils::evaluateBoard(*this, 0);
+        MoveExecutor::unmakeMove(*this, undo, player);
+
+        if ((player == 0 && scores[i] > bestScore) || (player == 1 && scores[i] < bestScore)) {
+            bestScore = scores[i];
         }
     }
 
-    std::vector<Move> bestMoves;
-    for (const Move& move : validMoves) {
-        ChessEngine hypotheticalEngine = *this;
-        MoveExecutor::makeMove(hypotheticalEngine, move, player);
-        int score = Utils::evaluateBoard(hypotheticalEngine, player);
-
-        if (score == bestScore) {
-            bestMoves.push_back(move);
+    MoveList bestMoves;
+    for (int i = 0; i < validMoves.size(); ++i) {
+        if (scores[i] == bestScore) {
+            bestMoves.push_back(validMoves[i]);
         }
     }
 
-    int randomIndex = std::rand() % bestMoves.size();
-    Move bestMove = bestMoves[randomIndex];
+    int randomIndex = std::uniform_int_distribution<int>(0, bestMoves.size() - 1)(random);
+    PackedMove bestMove = bestMoves[randomIndex];
 
     makeMove(bestMove, player);
 }
 
-void ChessEngine::makeMove(const Move& move, int player) {
-    if (status != GameStatus::IN_PROGRESS) {
-        std::cout << "Game over. No more moves allowed." << std::endl;
-        return;
-    }    
-
-    if (player == 0) {
-        std::cout << "Making move: " << Utils::positionToUCI(move.from) + Utils::positionToUCI(move.to) << " Player: white" <<  std::endl;
-    } else {
-        std::cout << "Making move: " << Utils::positionToUCI(move.from) + Utils::positionToUCI(move.to) << " Player: black" <<  std::endl;
+void ChessEngine::makeSearchMove(int player) {
+    if (!transpositionTable) {
+        transpositionTable = std::make_shared<TranspositionTable>(hashMegabytes, true);
     }
-    MoveExecutor::makeMove(*this, move, player);
-    
-    // if the move was a double pawn move, set the en passant target
-    if (player == 0 && (move.to == move.from + 16)) { // white double pawn move
-        enPassantTarget = move.from + 8;
-    } else if (player == 1 && (move.to == move.from - 16)) { // black double pawn move
-        enPassantTarget = move.from - 8;
-    } else {
-        enPassantTarget = -1;
+
+    SearchResult result = Search::search(*this, player, searchLimits, *transpositionTable, searchThreads, pinThreads, searchOptions);
+    if (result.pv.empty()) {
+        throw std::runtime_error("No valid moves available.");
     }
 
-    bool isPawnMove = ((whitePawns | blackPawns) & (1ULL << move.from)) != 0;
-    bool isCapture = ((whitePawns | whiteKnights | whiteBishops | whiteRooks | whiteQueens | whiteKing |
-                       blackPawns | blackKnights | blackBishops | blackRooks | blackQueens | blackKing) & (1ULL << move.to)) != 0;
+    // the clock runs while the player searches and gains the increment once the move is made
+    if (searchLimits.time[player] > 0) {
+        int spent = static_cast<int>(result.seconds * 1000);
+        searchLimits.time[player] = std::max(1, searchLimits.time[player] - spent) + searchLimits.increment[player];
+    }
 
-    if (isPawnMove || isCapture) {
-        halfMoveClock = 0;
-    } else {
-        halfMoveClock++;
+    if (!isHeadless()) {
+        std::cout << "Search depth " << result.depth << " score " << Search::scoreToString(result.score) << " pv";
+        for (PackedMove move : result.pv) {
+            std::cout << ' ' << Utils::moveToUCI(move);
+        }
+        std::cout << " (" << result.nodes << " nodes, " << static_cast<uint64_t>(result.nodes / std::max(result.seconds, 1e-9)) << " nodes/s)" << std::endl;
     }
 
-    // update position history
-    uint64_t hash = calculateZobristHash();
-    positionHistory[hash]++;
-    positionList.push_back(hash);
+    makeMove(result.bestMove, player);
+}
+
+void ChessEngine::setSearchDepth(int depth) { searchLimits.depth = depth; }
+void ChessEngine::setSearchLimits(const SearchLimits& limits) { searchLimits = limits; }
+const SearchLimits& ChessEngine::getSearchLimits() const { return searchLimits; }
 
-    updateGameStatus(player);
+void ChessEngine::setSearchThreads(int threads, bool pinThreads) {
+    searchThreads = threads;
+    this->pinThreads = pinThreads;
 }
 
-bool ChessEngine::isFiftyMoveDraw() const {
-    return halfMoveClock >= 100;
+void ChessEngine::setSearchOptions(const SearchOptions& options) { searchOptions = options; }
+
+void ChessEngine::setHashSize(size_t megabytes) {
+    hashMegabytes = megabytes;
+    transpositionTable.reset();
 }
 
-void ChessEngine::updateGameStatus(int player) {
-    if (status == GameStatus::BLACK_RESIGNS || status == GameStatus::WHITE_RESIGNS) {
+void ChessEngine::makeMove(const Move& move, int player) {
+    makeMove(move.toPacked(), player);
+}
+
+void ChessEngine::makeMove(PackedMove move, int player) {
+    // only a status that has already been worked out is checked, replaying moves does not pay for status detection
+    if (statusKnown && status != GameStatus::IN_PROGRESS) {
+        notify(EngineEvent::MOVE_REFUSED, move, player);
         return;
     }
-    std::string gameStatus = Utils::getGameStatus(*this, player);
-    if (gameStatus == "White is checkmated") {
-        status = GameStatus::WHITE_CHECKMATED;
-    } else if (gameStatus == "Black is checkmated") {
-        status = GameStatus::BLACK_CHECKMATED;
-    } else if (gameStatus == "Stalemate") {
-        status = GameStatus::STALEMATE;
-    } else if (gameStatus == "Insufficient material") {
-        status = GameStatus::INSUFFICIENT_MATERIAL;
-    } else if (gameStatus == "Fifty move draw") {
-        status = GameStatus::FIFTY_MOVE_DRAW;
-    } else if (gameStatus == "Threefold repetition") {
-        status = GameStatus::THREEFOLD_REPETITION;
-    } else if (gameStatus == "Draw agreement") {
-        status = GameStatus::DRAW_AGREEMENT;
-    } else {
-        status = GameStatus::IN_PROGRESS;
-    }
+
+    notify(EngineEvent::MOVE_MADE, move, player);
+
+    // also updates the en passant target, the castling flags, the half-move clock and the hash
+    MoveExecutor::makeMove(*this, move, player);
+
+    // update position history
+    recordPosition();
+
+    // the status is worked out on the next call to getGameStatus
+    statusKnown = false;
+}
+
+bool ChessEngine::isFiftyMoveDraw() const {
+    return halfMoveClock >= 100;
 }
 
 GameStatus ChessEngine::getGameStatus() const {
+    if (!statusKnown) {
+        status = Utils::getGameStatus(*this, 1 - sideToMove);
+        statusKnown = true;
+    }
     return status;
 }
 
@@ -564,22 +649,65 @@ std::vector<Move> ChessEngine::generateAllPossibleMoves(int player) const {
 }
 
 bool ChessEngine::getWhiteKingMoved() const { return whiteKingMoved; }
-void ChessEngine::setWhiteKingMoved(bool moved) { whiteKingMoved = moved; }
+void ChessEngine::setWhiteKingMoved(bool moved) { whiteKingMoved = moved; hash = calculateZobristHash(); }
 bool ChessEngine::getWhiteRookA1Moved() const { return whiteRookA1Moved; }
-void ChessEngine::setWhiteRookA1Moved(bool moved) { whiteRookA1Moved = moved; }
+void ChessEngine::setWhiteRookA1Moved(bool moved) { whiteRookA1Moved = moved; hash = calculateZobristHash(); }
 bool ChessEngine::getWhiteRookH1Moved() const { return whiteRookH1Moved; }
-void ChessEngine::setWhiteRookH1Moved(bool moved) { whiteRookH1Moved = moved; }
+void ChessEngine::setWhiteRookH1Moved(bool moved) { whiteRookH1Moved = moved; hash = calculateZobristHash(); }
 bool ChessEngine::getBlackKingMoved() const { return blackKingMoved; }
-void ChessEngine::setBlackKingMoved(bool moved) { blackKingMoved = moved; }
+void ChessEngine::setBlackKingMoved(bool moved) { blackKingMoved = moved; hash = calculateZobristHash(); }
 bool ChessEngine::getBlackRookA8Moved() const { return blackRookA8Moved; }
-void ChessEngine::setBlackRookA8Moved(bool moved) { blackRookA8Moved = moved; }
+void ChessEngine::setBlackRookA8Moved(bool moved) { blackRookA8Moved = moved; hash = calculateZobristHash(); }
 bool ChessEngine::getBlackRookH8Moved() const { return blackRookH8Moved; }
-void ChessEngine::setBlackRookH8Moved(bool moved) { blackRookH8Moved = moved; }
+void ChessEngine::setBlackRookH8Moved(bool moved) { blackRookH8Moved = moved; hash = calculateZobristHash(); }
 int ChessEngine::getEnPassantTarget() const { return enPassantTarget; }
-void ChessEngine::setEnPassantTarget(int target) { enPassantTarget = target; }
+void ChessEngine::setEnPassantTarget(int target) { enPassantTarget = target; hash = calculateZobristHash(); }
+uint64_t ChessEngine::getHash() const { return hash; }
+
+void ChessEngine::setHeadless(bool headless) { this->headless = headless; }
+
+bool ChessEngine::isHeadless() const {
+#ifdef CHESSIE_HEADLESS
+    return true;
+#else
+    return headless;
+#endif
+}
+
+void ChessEngine::setEventSink(EventSink sink) { eventSink = std::move(sink); }
+
+void ChessEngine::notify(EngineEvent event, PackedMove move, int player) const {
+    if (eventSink) {
+        eventSink(event, move, player);
+    }
+
+#ifndef CHESSIE_HEADLESS
+    if (headless) {
+        return;
+    }
+
+    switch (event) {
+        case EngineEvent::MOVE_MADE:
+            std::cout << "Making move: " << Utils::moveToUCI(move) << " Player: " << (player == 0 ? "white" : "black") << std::endl;
+            break;
+        case EngineEvent::MOVE_REFUSED:
+            std::cout << "Game over. No more moves allowed." << std::endl;
+            break;
+        case EngineEvent::MOVE_OUT_OF_BOUNDS:
+            std::cout << "Move is out of bounds" << std::endl;
+            break;
+        case EngineEvent::NO_PIECE_TO_MOVE:
+            std::cout << "No piece at from square" << std::endl;
+            break;
+    }
+#endif
+}
 
 void ChessEngine::parseArgs(int argc, char* argv[]) {
     GameMode mode = GameMode::HUMAN_VS_HUMAN; // default mode
+    int player = 0; // player to move in a position given by --fen
+    int threads = 1; // worker threads for --perft, --perft-suite, --bench and the search player
+    bool pin = false; // whether --bench and the search player pin their helper threads to cores
 
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -613,6 +741,123 @@ void ChessEngine::parseArgs(int argc, char* argv[]) {
                 Utils::printHelp();
                 exit(1);
             }
+        } else if (arg == "--fen") {
+            if (i + 1 < argc) {
+                try {
+                    player = loadFEN(argv[++i]);
+                } catch (const std::invalid_argument& e) {
+                    std::cerr << e.what() << std::endl;
+                    exit(1);
+                }
+            } else {
+                std::cerr << "No position provided after --fen" << std::endl;
+                Utils::printHelp();
+                exit(1);
+            }
+        } else if (arg == "--perft") {
+            if (i + 1 < argc) {
+                int depth = std::atoi(argv[++i]);
+                if (threads > 1) {
+                    Perft::parallelDivide(*this, player, depth, threads, std::cout);
+                } else {
+                    Perft::divide(*this, player, depth, std::cout);
+                }
+            } else {
+                std::cerr << "No depth provided after --perft" << std::endl;
+                Utils::printHelp();
+                exit(1);
+            }
+        } else if (arg == "--perft-suite") {
+            exit(Perft::runReferenceSuite(std::cout, threads) ? 0 : 1);
+        } else if (arg == "--threads") {
+            if (i + 1 < argc) {
+                threads = std::max(1, std::atoi(argv[++i]));
+                setSearchThreads(threads, pin);
+            } else {
+                std::cerr << "No thread count provided after --threads" << std::endl;
+                Utils::printHelp();
+                exit(1);
+            }
+        } else if (arg == "--depth") {
+            if (i + 1 < argc) {
+                setSearchDepth(std::max(0, std::atoi(argv[++i])));
+            } else {
+                std::cerr << "No depth provided after --depth" << std::endl;
+                Utils::printHelp();
+                exit(1);
+            }
+        } else if (arg == "--movetime") {
+            if (i + 1 < argc) {
+                searchLimits.moveTime = std::max(0, std::atoi(argv[++i]));
+            } else {
+                std::cerr << "No time provided after --movetime" << std::endl;
+                Utils::printHelp();
+                exit(1);
+            }
+        } else if (arg == "--nodes") {
+            if (i + 1 < argc) {
+                searchLimits.nodes = std::strtoull(argv[++i], nullptr, 10);
+            } else {
+                std::cerr << "No node count provided after --nodes" << std::endl;
+                Utils::printHelp();
+                exit(1);
+            }
+        } else if (arg == "--clock") {
+            if (i + 1 < argc) {
+                searchLimits.time[0] = searchLimits.time[1] = std::max(0, std::atoi(argv[++i]));
+            } else {
+                std::cerr << "No time provided after --clock" << std::endl;
+                Utils::printHelp();
+                exit(1);
+            }
+        } else if (arg == "--inc") {
+            if (i + 1 < argc) {
+                searchLimits.increment[0] = searchLimits.increment[1] = std::max(0, std::atoi(argv[++i]));
+            } else {
+                std::cerr << "No time provided after --inc" << std::endl;
+                Utils::printHelp();
+                exit(1);
+            }
+        } else if (arg == "--hash") {
+            if (i + 1 < argc) {
+                setHashSize(std::max(1, std::atoi(argv[++i])));
+            } else {
+                std::cerr << "No size provided after --hash" << std::endl;
+                Utils::printHelp();
+                exit(1);
+            }
+        } else if (arg == "--pin") {
+            pin = true;
+            setSearchThreads(threads, pin);
+        } else if (arg == "--bench") {
+            Search::runBenchmark(std::cout, std::max(1, searchLimits.depth), threads, hashMegabytes, pin);
+            exit(0);
+        } else if (arg == "--bench-pruning") {
+            Search::runPruningBenchmark(std::cout, std::max(1, searchLimits.depth), hashMegabytes);
+            exit(0);
+        } else if (arg == "--disable") {
+            if (i + 1 < argc) {
+                std::string technique = argv[++i];
+                if (technique == "nmp") {
+                    searchOptions.nullMovePruning = false;
+                } else if (technique == "lmr") {
+                    searchOptions.lateMoveReductions = false;
+                } else if (technique == "rfp") {
+                    searchOptions.reverseFutilityPruning = false;
+                } else if (technique == "fp") {
+                    searchOptions.futilityPruning = false;
+                } else {
+                    std::cerr << "Invalid technique: " << technique << std::endl;
+                    Utils::printHelp();
+                    exit(1);
+                }
+            } else {
+                std::cerr << "No technique provided after --disable" << std::endl;
+                Utils::printHelp();
+                exit(1);
+            }
+        } else if (arg == "--headless") {
+            setHeadless(true);
         } else if (arg == "--mode") {
             if (i + 1 < argc) {
                 std::string modeStr = argv[++i];
@@ -622,6 +867,10 @@ void ChessEngine::parseArgs(int argc, char* argv[]) {
                     mode = GameMode::HUMAN_VS_AI;
                 } else if (modeStr == "ava") {
                     mode = GameMode::AI_VS_AI;
+                } else if (modeStr == "hvs") {
+                    mode = GameMode::HUMAN_VS_SEARCH;
+                } else if (modeStr == "svs") {
+                    mode = GameMode::SEARCH_VS_SEARCH;
                 } else {
                     std::cerr << "Invalid mode: " << modeStr << std::endl;
                     Utils::printHelp();
@@ -1,12 +1,16 @@
 #ifndef CHESSENGINE_HPP
 #define CHESSENGINE_HPP
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
 #include <string>
 #include <vector>
 #include <stdexcept>
-#include <unordered_map>
 #include "movegenerator.hpp"
+#include "searchlimits.hpp"
 
 enum class GameStatus {
     IN_PROGRESS,
@@ -24,13 +28,33 @@ enum class GameStatus {
 enum class GameMode {
     HUMAN_VS_HUMAN,
     HUMAN_VS_AI,
-    AI_VS_AI
+    AI_VS_AI,
+    HUMAN_VS_SEARCH,
+    SEARCH_VS_SEARCH
 };
 
 enum class PlayerType {
     HUMAN,
     RANDOM_AI,
-    GREEDY_AI
+    GREEDY_AI,
+    SEARCH_AI
+};
+
+// indexes the second dimension of ChessEngine::bitboards; a piece is identified by player * 6 + type
+enum PieceType {
+    PAWN,
+    KNIGHT,
+    BISHOP,
+    ROOK,
+    QUEEN,
+    KING
+};
+
+// indexes ChessEngine::occupancy: the squares of each player, and of both
+enum Occupancy {
+    WHITE,
+    BLACK,
+    ALL
 };
 
 /**
@@ -43,8 +67,109 @@ enum class PlayerType {
 std::ostream& operator<<(std::ostream& os, const GameStatus& status);
 
 
+/**
+ * @brief Compact 16-bit move used by move generation, validation and execution.
+ * Bits 0-5 hold the from square, bits 6-11 the to square and bits 12-15 the flags (the promotion piece, if any).
+ * Castling and en passant are recognized from the board when the move is executed, so a move can be built from
+ * square indices alone and converted to and from UCI text without a board.
+ */
+struct PackedMove {
+    enum Flag {
+        NONE = 0,
+        PROMOTE_KNIGHT = 1,
+        PROMOTE_BISHOP = 2,
+        PROMOTE_ROOK = 3,
+        PROMOTE_QUEEN = 4
+    };
+
+    uint16_t data;
+
+    /**
+     * @brief Default constructor. Leaves the move uninitialized so that move lists can be allocated without touching every slot.
+     */
+    PackedMove() = default;
+
+    /**
+     * @brief Constructor for the PackedMove struct.
+     * @param from The origin square index (0-63).
+     * @param to The destination square index (0-63).
+     * @param flags The move flags, NONE or one of the PROMOTE_* values.
+     */
+    constexpr PackedMove(int from, int to, int flags = NONE)
+        : data(static_cast<uint16_t>(from | (to << 6) | (flags << 12))) {}
+
+    constexpr int from() const { return data & 0x3F; }
+    constexpr int to() const { return (data >> 6) & 0x3F; }
+    constexpr int flags() const { return data >> 12; }
+    constexpr bool isPromotion() const { return flags() != NONE; }
+
+    constexpr bool operator==(const PackedMove& other) const { return data == other.data; }
+    constexpr bool operator!=(const PackedMove& other) const { return data != other.data; }
+
+    /**
+     * @brief Gets the promotion piece in UCI notation.
+     * @return char 'n', 'b', 'r' or 'q' for promotions, '\0' otherwise.
+     */
+    char promotion() const {
+        static const char pieces[] = {'\0', 'n', 'b', 'r', 'q'};
+        return flags() <= PROMOTE_QUEEN ? pieces[flags()] : '\0';
+    }
+
+    /**
+     * @brief Converts a UCI promotion piece to a move flag.
+     * @param piece The promotion piece ('n', 'b', 'r' or 'q').
+     * @return int The matching PROMOTE_* flag, or -1 if the character is not a promotion piece.
+     */
+    static int promotionFlag(char piece) {
+        switch (piece) {
+            case 'n': return PROMOTE_KNIGHT;
+            case 'b': return PROMOTE_BISHOP;
+            case 'r': return PROMOTE_ROOK;
+            case 'q': return PROMOTE_QUEEN;
+            default: return -1;
+        }
+    }
+
+    /**
+     * @brief Parses a square in algebraic notation without allocating or throwing.
+     * @param text Pointer to the two characters of the square, e.g. "e4".
+     * @return int The square index (0-63), or -1 if the characters do not name a square.
+     */
+    static int parseSquare(const char* text) {
+        if (text[0] < 'a' || text[0] > 'h' || text[1] < '1' || text[1] > '8') {
+            return -1;
+        }
+        return (text[1] - '1') * 8 + (text[0] - 'a');
+    }
+
+    /**
+     * @brief Parses a move in UCI notation without allocating or throwing.
+     * @param text The characters of the move, e.g. "e2e4" or "a7a8q". Need not be null-terminated.
+     * @param length The number of characters.
+     * @param move The parsed move. Only written on success.
+     * @return true If the text is a well-formed UCI move.
+     * @return false Otherwise.
+     */
+    static bool parse(const char* text, std::size_t length, PackedMove& move) {
+        if (length != 4 && length != 5) {
+            return false;
+        }
+
+        int from = parseSquare(text);
+        int to = parseSquare(text + 2);
+        int flags = length == 5 ? promotionFlag(text[4]) : NONE;
+        if (from < 0 || to < 0 || flags < 0) {
+            return false;
+        }
+
+        move = PackedMove(from, to, flags);
+        return true;
+    }
+};
+
 /**
  * @brief Struct to represent a move in the UCI format. E.g: "e2e4" (move 2 squares ahead with a pawn), "a7a8q" (pawn promotion to queen).
+ * Used at the I/O boundary; generation and execution work on PackedMove.
  */
 struct Move {
     int from;
@@ -61,40 +186,101 @@ struct Move {
             throw std::invalid_argument("Invalid position length");
         }
 
-        char file = pos[0];
-        char rank = pos[1];
-
-        if (file < 'a' || file > 'h' || rank < '1' || rank > '8') {
+        int square = PackedMove::parseSquare(pos.data());
+        if (square < 0) {
             throw std::invalid_argument("Invalid position format");
         }
 
-        int fileIndex = file - 'a'; // 'a' -> 0, 'b' -> 1, ..., 'h' -> 7
-        int rankIndex = rank - '1'; // '1' -> 0, '2' -> 1, ..., '8' -> 7
-
-        return rankIndex * 8 + fileIndex; // 0-63
+        return square; // 0-63
     }
 
+    /**
+     * @brief Default constructor. Leaves the move uninitialized.
+     */
+    Move() = default;
+
     /** 
      * @brief Constructor for the Move struct.
      * @param notation The move in UCI notation.
+     * @throws std::invalid_argument If the notation is not a well-formed UCI move.
     */
     Move(const std::string& notation) 
         : from(-1), to(-1), promotion('\0') {
-        if (notation.length() == 4) { // regular move
-            from = positionToInt(notation.substr(0, 2));
-            to = positionToInt(notation.substr(2, 2));
-        } else if (notation.length() == 5) { // pawn promotion
-            from = positionToInt(notation.substr(0, 2));
-            to = positionToInt(notation.substr(2, 2));
-            promotion = notation[4];
-        } else {
+        PackedMove move;
+        if (!PackedMove::parse(notation.data(), notation.length(), move)) {
             throw std::invalid_argument("Invalid UCI move format");
         }
+        *this = Move(move);
+    }
+
+    /**
+     * @brief Converts a packed move.
+     * @param move The packed move.
+     */
+    explicit Move(PackedMove move)
+        : from(move.from()), to(move.to()), promotion(move.promotion()) {}
+
+    /**
+     * @brief Converts the move to its packed form. The squares must be on the board.
+     * @return PackedMove The packed move. Unknown promotion characters are dropped.
+     */
+    PackedMove toPacked() const {
+        int flags = PackedMove::promotionFlag(promotion);
+        return PackedMove(from, to, flags < 0 ? PackedMove::NONE : flags);
     }
 };
 
+/**
+ * @brief Fixed-capacity list of moves, allocated on the stack and filled in place by the move generator.
+ * 256 entries exceed the largest number of moves possible in any chess position (218).
+ */
+struct MoveList {
+    static const int capacity = 256;
+
+    PackedMove moves[capacity];
+    int count = 0;
+
+    /**
+     * @brief Appends a move to the list.
+     * @param move The move to append.
+     */
+    void push_back(PackedMove move) { moves[count++] = move; }
+
+    /**
+     * @brief Removes all moves from the list.
+     */
+    void clear() { count = 0; }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    PackedMove& operator[](int index) { return moves[index]; }
+    const PackedMove& operator[](int index) const { return moves[index]; }
+
+    PackedMove* begin() { return moves; }
+    PackedMove* end() { return moves + count; }
+    const PackedMove* begin() const { return moves; }
+    const PackedMove* end() const { return moves + count; }
+};
+
+/**
+ * @brief Events the engine reports while moves are made and validated.
+ */
+enum class EngineEvent {
+    MOVE_MADE,            // a move was played
+    MOVE_REFUSED,         // a move was refused because the game is over
+    MOVE_OUT_OF_BOUNDS,   // the validator rejected a move with a square off the board
+    NO_PIECE_TO_MOVE      // the validator rejected a move whose from square holds no piece of the player
+};
+
+/**
+ * @brief Receives engine events. The move is empty for events that are not about a well-formed move.
+ */
+using EventSink = std::function<void(EngineEvent event, PackedMove move, int player)>;
+
 class MoveValidator;
 class MoveExecutor;
+class TranspositionTable;
 
 class ChessEngine {
 public:
@@ -107,7 +293,7 @@ public:
 
     /**
      * @brief Constructor for the ChessEngine class.
-     * Initializes the Zobrist table and starts a new game.
+     * Starts a new game.
      */
     ChessEngine();
 
@@ -124,6 +310,14 @@ public:
      */
     void makeMove(const Move& move, int player);
 
+    /**
+     * @brief Makes a move on the board. Updates the board state and checks for game status.
+     *
+     * @param move The move to make.
+     * @param player The player making the move.
+     */
+    void makeMove(PackedMove move, int player);
+
     /**
      * @brief Makes a random valid move for the current player. 0 for white, 1 for black.
      *
@@ -137,6 +331,59 @@ public:
      * @param player The player making the move.
      */
     void makeGreedyMove(int player);
+
+    /**
+     * @brief Makes the best move found by an alpha-beta search to the search depth. Unless headless, prints the
+     * score, the principal variation and the search speed.
+     *
+     * @param player The player making the move.
+     */
+    void makeSearchMove(int player);
+
+    /**
+     * @brief Sets the depth the search player looks ahead.
+     *
+     * @param depth The depth in plies, 0 for no depth limit.
+     */
+    void setSearchDepth(int depth);
+
+    /**
+     * @brief Sets the limits of the search player's moves. A game clock in the limits is kept running: after each
+     * search move the time spent is taken off the player's clock and the increment is added.
+     *
+     * @param limits The depth, node and time limits.
+     */
+    void setSearchLimits(const SearchLimits& limits);
+
+    /**
+     * @brief Gets the limits of the search player's moves, including the current game clock.
+     *
+     * @return const SearchLimits& The limits.
+     */
+    const SearchLimits& getSearchLimits() const;
+
+    /**
+     * @brief Sets the size of the transposition table used by the search player. The table is allocated on the next
+     * search move and then kept for the rest of the game, so results carry over from one move to the next.
+     *
+     * @param megabytes The table size in megabytes.
+     */
+    void setHashSize(size_t megabytes);
+
+    /**
+     * @brief Sets the number of threads the search player searches with.
+     *
+     * @param threads The number of threads, including the calling thread.
+     * @param pinThreads Whether to pin the helper threads to cores.
+     */
+    void setSearchThreads(int threads, bool pinThreads = false);
+
+    /**
+     * @brief Sets which selective techniques the search player uses.
+     *
+     * @param options The options, see SearchOptions.
+     */
+    void setSearchOptions(const SearchOptions& options);
     
     /**
      * @brief Generates all possible moves for the given player.
@@ -145,8 +392,51 @@ public:
      */
     std::vector<Move> generateAllPossibleMoves(int player) const;
 
-    uint64_t whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing;
-    uint64_t blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing;
+    /**
+     * @brief Gets the bitboard of one piece type of one player.
+     *
+     * @param player The player owning the pieces (0 for white, 1 for black).
+     * @param type The piece type.
+     * @return uint64_t The bitboard of the pieces.
+     */
+    uint64_t pieces(int player, int type) const { return bitboards[player][type]; }
+
+    /**
+     * @brief Gets the bitboard of all pieces of one player.
+     *
+     * @param player The player owning the pieces (0 for white, 1 for black).
+     * @return uint64_t The bitboard of the pieces.
+     */
+    uint64_t playerPieces(int player) const { return occupancy[player]; }
+
+    /**
+     * @brief Gets the bitboard of all occupied squares.
+     *
+     * @return uint64_t The bitboard of the pieces of both players.
+     */
+    uint64_t allPieces() const { return occupancy[ALL]; }
+
+    /**
+     * @brief Gets the piece standing on a square.
+     *
+     * @param square The square index (0-63).
+     * @return int The piece (player * 6 + type), or -1 if the square is empty.
+     */
+    int pieceAt(int square) const { return pieceOn[square]; }
+
+    // named bitboard accessors
+    uint64_t whitePawns() const { return bitboards[0][PAWN]; }
+    uint64_t whiteKnights() const { return bitboards[0][KNIGHT]; }
+    uint64_t whiteBishops() const { return bitboards[0][BISHOP]; }
+    uint64_t whiteRooks() const { return bitboards[0][ROOK]; }
+    uint64_t whiteQueens() const { return bitboards[0][QUEEN]; }
+    uint64_t whiteKing() const { return bitboards[0][KING]; }
+    uint64_t blackPawns() const { return bitboards[1][PAWN]; }
+    uint64_t blackKnights() const { return bitboards[1][KNIGHT]; }
+    uint64_t blackBishops() const { return bitboards[1][BISHOP]; }
+    uint64_t blackRooks() const { return bitboards[1][ROOK]; }
+    uint64_t blackQueens() const { return bitboards[1][QUEEN]; }
+    uint64_t blackKing() const { return bitboards[1][KING]; }
 
     /**
      * @brief Gets the status of the white king's movement.
@@ -253,7 +543,46 @@ public:
     void setEnPassantTarget(int target);
 
     /**
-     * @brief Gets the current game status.
+     * @brief Switches console output off or on. In headless mode the engine, the validator and the game loops do no
+     * stream I/O and events are only passed to the event sink. Building with CHESSIE_HEADLESS makes every engine headless.
+     *
+     * @param headless Whether to run without console output.
+     */
+    void setHeadless(bool headless);
+
+    /**
+     * @brief Checks whether the engine runs without console output.
+     *
+     * @return true If the engine is headless.
+     * @return false Otherwise.
+     */
+    bool isHeadless() const;
+
+    /**
+     * @brief Sets the callback that receives engine events, in addition to the console output when not headless.
+     *
+     * @param sink The callback, or an empty function to remove it.
+     */
+    void setEventSink(EventSink sink);
+
+    /**
+     * @brief Gets the Zobrist hash of the current position, maintained incrementally as moves are made.
+     *
+     * @return uint64_t The Zobrist hash.
+     */
+    uint64_t getHash() const;
+
+    /**
+     * @brief Calculates the Zobrist hash for the current position from scratch, which the incrementally maintained
+     * hash must always equal.
+     *
+     * @return uint64_t The Zobrist hash.
+     */
+    uint64_t calculateZobristHash() const;
+
+    /**
+     * @brief Gets the current game status. The status is only worked out from the board when it is first asked for
+     * after a move, so moves that are never followed by a status query do not pay for mate detection.
      *
      * @return GameStatus The current game status.
      */    
@@ -274,9 +603,10 @@ public:
     void playerMove(int player);
 
     /**
-     * @brief Checks if the game is a draw by repetition.
+     * @brief Checks if the game is a draw by repetition. Only the current position is compared, against the
+     * positions with the same side to move since the last capture or pawn move.
      *
-     * @return true If the same position has occurred three times.
+     * @return true If the current position has occurred three times.
      * @return false Otherwise.
      */        
     bool isRepetitionDraw() const;
@@ -319,6 +649,15 @@ public:
      */
     void loadGameFromFile(const std::string& path, bool isEval);    
 
+    /**
+     * @brief Sets up a position from Forsyth-Edwards Notation and clears the history.
+     *
+     * @param fen The position, e.g. "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1". The move counters are optional.
+     * @return int The player to move (0 for white, 1 for black).
+     * @throws std::invalid_argument If the FEN is malformed.
+     */
+    int loadFEN(const std::string& fen);
+
 private:
     /**
      * @brief Checks if a square is within the board.
@@ -354,23 +693,37 @@ private:
     bool handleDrawAgreement(int player);
     
     /**
-     * @brief Updates the game status based on the current board state after a move is made.
+     * @brief Gets the Zobrist keys of the castling rights that are still available.
      *
-     * @param player The player currently making a move.
+     * @return uint64_t The XOR of the castling keys.
      */
-    void updateGameStatus(int player);
+    uint64_t castlingHash() const;
 
     /**
-     * @brief Calculates the Zobrist hash for the current position.
+     * @brief Gets the Zobrist key of the en passant file, if any.
      *
-     * @return uint64_t The Zobrist hash.
-     */    
-    uint64_t calculateZobristHash() const;
+     * @return uint64_t The en passant key, or 0 if there is no en passant target.
+     */
+    uint64_t enPassantHash() const;
 
     /**
-     * @brief Initializes the Zobrist table for hashing.
+     * @brief Reports an event to the event sink and, unless headless, to the console.
+     *
+     * @param event The event.
+     * @param move The move the event is about.
+     * @param player The player the event is about (0 for white, 1 for black).
+     */
+    void notify(EngineEvent event, PackedMove move, int player) const;
+
+    /**
+     * @brief Appends the current position to the position history.
+     */
+    void recordPosition();
+
+    /**
+     * @brief Rebuilds the mailbox and the occupancy bitboards from the piece bitboards after the position has been set up wholesale.
      */
-    void initializeZobristTable();
+    void updateMailboxAndOccupancy();
 
     // castling flags
     bool whiteKingMoved, whiteRookA1Moved, whiteRookH1Moved;
@@ -379,24 +732,47 @@ private:
     PlayerType whitePlayerType;
     PlayerType blackPlayerType;
 
+    SearchLimits searchLimits; // limits and game clock of the SEARCH_AI player
+    size_t hashMegabytes;  // size of the search player's transposition table
+    int searchThreads;     // threads of the search player, see Search
+    bool pinThreads;       // whether the search player pins its helper threads to cores
+    SearchOptions searchOptions; // selective techniques of the search player
+    std::shared_ptr<TranspositionTable> transpositionTable; // allocated by the first search move, shared by copies of the engine
+    bool headless;         // no console output, see setHeadless
+    std::mt19937 random;   // move choice of the random and greedy players, one generator per engine
+    EventSink eventSink;   // optional receiver of engine events
+
     // en passant target square (-1 if not applicable)
     int enPassantTarget;
 
-    GameStatus status;
+    // piece-square scores for white and the game phase, kept up to date as pieces are placed and removed, see Evaluation
+    int middlegameScore, endgameScore, gamePhase;
+
+    // game status, valid only while statusKnown is set (worked out lazily by getGameStatus)
+    mutable GameStatus status;
+    mutable bool statusKnown;
+
+    // history of board positions: a ring buffer of the hashes of the positions reached, indexed by ply.
+    // only positions since the last capture or pawn move can repeat, and the fifty-move rule ends the game
+    // 100 plies after one, so a fixed window suffices
+    static const int historySize = 256;
+    uint64_t positionHistory[historySize];
+    int historyCount;
 
-    // history of board positions
-    std::unordered_map<uint64_t, int> positionHistory;
-    std::vector<uint64_t> positionList;
+    uint64_t bitboards[2][6]; // [player][piece type]
+    int8_t pieceOn[64];       // mailbox: the piece (player * 6 + type) on every square, -1 if empty
+    uint64_t occupancy[3];    // [WHITE], [BLACK] and [ALL] occupied squares
 
-    uint64_t zobristTable[12][64]; // 6 pieces for each color on 64 squares
-    uint64_t zobristCastle[4];     // 4 castling rights (white king, white queen, black king, black queen)
-    uint64_t zobristEnPassant[8];  // 8 possible en passant files
-    uint64_t zobristSide;          // side to move
+    uint64_t hash;   // Zobrist hash of the current position, updated by MoveExecutor
+    int sideToMove;  // player to move (0 for white, 1 for black), part of the hash
     int halfMoveClock;    
 
     friend class MoveValidator;
     friend class MoveExecutor;
     friend class MoveGenerator;
+    friend class Perft;
+    friend class Search;
+    friend class Evaluation;
 };
 
 #endif // CHESSENGINE_HPP
\ No newline at end of file
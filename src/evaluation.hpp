@@ -0,0 +1,80 @@
+#ifndef EVALUATION_HPP
+#define EVALUATION_HPP
+
+#include "chessengine.hpp"
+
+/**
+ * @brief Score of every piece on every square, the piece value plus its square bonus, for both game phases. White
+ * pieces score positively and black pieces negatively, so the sum over the board is the score for white.
+ */
+struct EvaluationTables {
+    int middlegame[12][64]; // by piece (player * 6 + type) and square
+    int endgame[12][64];
+};
+
+/**
+ * @class Evaluation
+ * @brief Tapered static evaluation from piece-square tables. The middlegame and endgame scores of a position are the
+ * sums of the table entries of its pieces, and the game phase counts the remaining minor and major pieces; the final
+ * score blends the two scores by the phase. The engine keeps all three up to date as pieces are placed and removed,
+ * so evaluating a position costs the same however many pieces are on the board.
+ */
+class Evaluation {
+public:
+    static const int maxPhase = 24; // game phase of the starting position, the pure middlegame
+
+    /**
+     * @brief Gets the middlegame score of a piece on a square.
+     * @param piece The piece index (0-5 white pawn to king, 6-11 black pawn to king).
+     * @param square The square index (0-63).
+     * @return int The score in centipawns for white.
+     */
+    static int middlegame(int piece, int square) { return tables.middlegame[piece][square]; }
+
+    /**
+     * @brief Gets the endgame score of a piece on a square.
+     * @param piece The piece index (0-5 white pawn to king, 6-11 black pawn to king).
+     * @param square The square index (0-63).
+     * @return int The score in centipawns for white.
+     */
+    static int endgame(int piece, int square) { return tables.endgame[piece][square]; }
+
+    /**
+     * @brief Gets how much a piece counts towards the game phase: 1 for a minor piece, 2 for a rook, 4 for a queen.
+     * @param piece The piece index (0-11).
+     * @return int The phase weight.
+     */
+    static int phase(int piece) { return phaseWeights[piece % 6]; }
+
+    /**
+     * @brief Evaluates a position from the scores the engine keeps up to date.
+     * @param engine The position.
+     * @param player The player to evaluate for (0 for white, 1 for black).
+     * @return int The score in centipawns from the point of view of the player.
+     */
+    static int evaluate(const ChessEngine& engine, int player);
+
+    /**
+     * @brief Blends a middlegame and an endgame score by the game phase.
+     * @param middlegame The middlegame score.
+     * @param endgame The endgame score.
+     * @param phase The game phase, capped at maxPhase where the middlegame score counts alone.
+     * @return int The blended score.
+     */
+    static int taper(int middlegame, int endgame, int phase);
+
+    /**
+     * @brief Sums the scores and the game phase over every piece on the board, for a position set up wholesale.
+     * @param engine The position.
+     * @param middlegame Receives the middlegame score for white.
+     * @param endgame Receives the endgame score for white.
+     * @param phase Receives the game phase.
+     */
+    static void computeScores(const ChessEngine& engine, int& middlegame, int& endgame, int& phase);
+
+private:
+    static const int phaseWeights[6];
+    static const EvaluationTables tables;
+};
+
+#endif // EVALUATION_HPP
@@ -1,161 +1,191 @@
 #include "moveexecutor.hpp"
+#include "evaluation.hpp"
 #include "movevalidator.hpp"
+#include "zobrist.hpp"
 
 void MoveExecutor::makeMove(ChessEngine& engine, const Move& move, int player) {
-    uint64_t fromBit = 1ULL << move.from;
-    uint64_t toBit = 1ULL << move.to;
-
-    // handle castling
-    if ((move.from == 4 && move.to == 6 && MoveValidator::canCastleKingside(player, engine)) ||
-        (move.from == 4 && move.to == 2 && MoveValidator::canCastleQueenside(player, engine)) ||
-        (move.from == 60 && move.to == 62 && MoveValidator::canCastleKingside(player, engine)) ||
-        (move.from == 60 && move.to == 58 && MoveValidator::canCastleQueenside(player, engine))) {
-        if (player == 0) {
-            // white castling
-            if (move.to == 6) {
-                // kingside castling
-                removePiece(engine.whiteKing, 4);
-                placePiece(engine.whiteKing, 6);
-                removePiece(engine.whiteRooks, 7);
-                placePiece(engine.whiteRooks, 5);
-            } else {
-                // queenside castling
-                removePiece(engine.whiteKing, 4);
-                placePiece(engine.whiteKing, 2);
-                removePiece(engine.whiteRooks, 0);
-                placePiece(engine.whiteRooks, 3);
-            }
-        } else {
-            // black castling
-            if (move.to == 62) {
-                // kingside castling
-                removePiece(engine.blackKing, 60);
-                placePiece(engine.blackKing, 62);
-                removePiece(engine.blackRooks, 63);
-                placePiece(engine.blackRooks, 61);
-            } else {
-                // queenside castling
-                removePiece(engine.blackKing, 60);
-                placePiece(engine.blackKing, 58);
-                removePiece(engine.blackRooks, 56);
-                placePiece(engine.blackRooks, 59);
-            }
-        }
-        return;
-    }
+    makeMove(engine, move.toPacked(), player);
+}
 
-    // handle en passant
-    if (move.to == engine.getEnPassantTarget()) {
-        int captureSquare = player == 0 ? move.to - 8 : move.to + 8;
-        if (player == 0) {
-            removePiece(engine.blackPawns, captureSquare);
-        } else {
-            removePiece(engine.whitePawns, captureSquare);
-        }
+void MoveExecutor::makeMove(ChessEngine& engine, PackedMove move, int player) {
+    int from = move.from();
+    int to = move.to();
+    int pawn = player * 6 + PAWN;
+    int king = player * 6 + KING;
+
+    // the mailbox tells the moving and the captured piece without searching the bitboards
+    int movedPiece = engine.pieceOn[from];
+    int capturedPiece = engine.pieceOn[to];
+    if (movedPiece == -1 || movedPiece / 6 != player) {
+        return;
     }
+    bool isEnPassant = movedPiece == pawn && to == engine.enPassantTarget;
 
-    // handle promotion
-    if (move.promotion != '\0') {
-        uint64_t& pawns = player == 0 ? engine.whitePawns : engine.blackPawns;
-        uint64_t& promotedPiece = (move.promotion == 'q') ? (player == 0 ? engine.whiteQueens : engine.blackQueens) :
-                                 (move.promotion == 'r') ? (player == 0 ? engine.whiteRooks : engine.blackRooks) :
-                                 (move.promotion == 'b') ? (player == 0 ? engine.whiteBishops : engine.blackBishops) :
-                                 (player == 0 ? engine.whiteKnights : engine.blackKnights);
+    // take the old castling rights and en passant file out of the hash, they are added back once updated
+    engine.hash ^= engine.castlingHash() ^ engine.enPassantHash();
 
-        removePiece(pawns, move.from);
-        placePiece(promotedPiece, move.to);
-        return;
+    // update the half-move clock and the en passant target
+    if (movedPiece == pawn || capturedPiece != -1) {
+        engine.halfMoveClock = 0;
+    } else {
+        engine.halfMoveClock++;
+    }
+    if (movedPiece == pawn && (to == from + 16 || to == from - 16)) {
+        engine.enPassantTarget = (from + to) / 2;
+    } else {
+        engine.enPassantTarget = -1;
     }
 
     // remove any piece that is being captured
-    removePiece(engine.whitePawns, move.to);
-    removePiece(engine.whiteKnights, move.to);
-    removePiece(engine.whiteBishops, move.to);
-    removePiece(engine.whiteRooks, move.to);
-    removePiece(engine.whiteQueens, move.to);
-    removePiece(engine.whiteKing, move.to);
-    removePiece(engine.blackPawns, move.to);
-    removePiece(engine.blackKnights, move.to);
-    removePiece(engine.blackBishops, move.to);
-    removePiece(engine.blackRooks, move.to);
-    removePiece(engine.blackQueens, move.to);
-    removePiece(engine.blackKing, move.to);
-
-    uint64_t pawns = player == 0 ? engine.whitePawns : engine.blackPawns;
-    uint64_t knights = player == 0 ? engine.whiteKnights : engine.blackKnights;
-    uint64_t bishops = player == 0 ? engine.whiteBishops : engine.blackBishops;
-    uint64_t rooks = player == 0 ? engine.whiteRooks : engine.blackRooks;
-    uint64_t queens = player == 0 ? engine.whiteQueens : engine.blackQueens;
-    uint64_t king = player == 0 ? engine.whiteKing : engine.blackKing;
-
-    if (pawns & fromBit) {
-        removePiece(pawns, move.from);
-        placePiece(pawns, move.to);
-        if (player == 0) {
-            engine.whitePawns = pawns;
-        } else {
-            engine.blackPawns = pawns;
-        }
-    } else if (knights & fromBit) {
-        removePiece(knights, move.from);
-        placePiece(knights, move.to);
-        if (player == 0) {
-            engine.whiteKnights = knights;
-        } else {
-            engine.blackKnights = knights;
-        }
-    } else if (bishops & fromBit) {
-        removePiece(bishops, move.from);
-        placePiece(bishops, move.to);
-        if (player == 0) {
-            engine.whiteBishops = bishops;
-        } else {
-            engine.blackBishops = bishops;
-        }
-    } else if (rooks & fromBit) {
-        removePiece(rooks, move.from);
-        placePiece(rooks, move.to);
-        if (player == 0) {
-            engine.whiteRooks = rooks;
+    if (capturedPiece != -1) {
+        removePiece(engine, capturedPiece, to);
+    }
+    if (isEnPassant) {
+        removePiece(engine, (1 - player) * 6 + PAWN, player == 0 ? to - 8 : to + 8);
+    }
+
+    // move the piece, replacing a promoting pawn with the chosen piece
+    removePiece(engine, movedPiece, from);
+    placePiece(engine, move.isPromotion() ? pawn + move.flags() : movedPiece, to);
+
+    // handle castling (the king moves two files), the rook jumps over the king
+    if (movedPiece == king && (to == from + 2 || to == from - 2)) {
+        int rook = player * 6 + ROOK;
+        int rank = player == 0 ? 0 : 56;
+        if (to > from) {
+            removePiece(engine, rook, rank + 7);
+            placePiece(engine, rook, rank + 5);
         } else {
-            engine.blackRooks = rooks;
+            removePiece(engine, rook, rank);
+            placePiece(engine, rook, rank + 3);
         }
-    } else if (queens & fromBit) {
-        removePiece(queens, move.from);
-        placePiece(queens, move.to);
+    }
+
+    // update castling flags, a rook that moves or is captured on its original square can no longer castle
+    if (movedPiece == king) {
         if (player == 0) {
-            engine.whiteQueens = queens;
+            engine.whiteKingMoved = true;
         } else {
-            engine.blackQueens = queens;
+            engine.blackKingMoved = true;
         }
-    } else if (king & fromBit) {
-        removePiece(king, move.from);
-        placePiece(king, move.to);
-        if (player == 0) {
-            engine.whiteKing = king;
+    }
+    if (from == 0 || to == 0) engine.whiteRookA1Moved = true;
+    if (from == 7 || to == 7) engine.whiteRookH1Moved = true;
+    if (from == 56 || to == 56) engine.blackRookA8Moved = true;
+    if (from == 63 || to == 63) engine.blackRookH8Moved = true;
+
+    engine.hash ^= engine.castlingHash() ^ engine.enPassantHash() ^ Zobrist::side();
+    engine.sideToMove = 1 - player;
+}
+
+bool MoveExecutor::makeMove(ChessEngine& engine, PackedMove move, int player, UndoRecord& undo) {
+    // refuse the move before touching the record, so a caller never unmakes a move that was not made
+    int movedPiece = engine.pieceOn[move.from()];
+    if (movedPiece == -1 || movedPiece / 6 != player) {
+        return false;
+    }
+
+    undo.move = move;
+    undo.hash = engine.hash;
+    undo.enPassantTarget = static_cast<int8_t>(engine.enPassantTarget);
+    undo.halfMoveClock = engine.halfMoveClock;
+    undo.castlingFlags = static_cast<uint8_t>(engine.whiteKingMoved | engine.whiteRookA1Moved << 1 | engine.whiteRookH1Moved << 2 |
+                                              engine.blackKingMoved << 3 | engine.blackRookA8Moved << 4 | engine.blackRookH8Moved << 5);
+
+    // an en passant capture takes a pawn that is not on the destination square
+    undo.capturedPiece = engine.pieceOn[move.to()];
+    if (movedPiece == player * 6 + PAWN && move.to() == engine.enPassantTarget) {
+        undo.capturedPiece = static_cast<int8_t>((1 - player) * 6 + PAWN);
+    }
+
+    makeMove(engine, move, player);
+    return true;
+}
+
+void MoveExecutor::unmakeMove(ChessEngine& engine, const UndoRecord& undo, int player) {
+    int from = undo.move.from();
+    int to = undo.move.to();
+    int pawn = player * 6 + PAWN;
+    int king = player * 6 + KING;
+
+    int movedPiece = engine.pieceOn[to];
+    if (movedPiece == king && (to == from + 2 || to == from - 2)) {
+        // castling, put the rook back on its corner
+        int rook = player * 6 + ROOK;
+        int rank = player == 0 ? 0 : 56;
+        if (to > from) {
+            removePiece(engine, rook, rank + 5);
+            placePiece(engine, rook, rank + 7);
         } else {
-            engine.blackKing = king;
+            removePiece(engine, rook, rank + 3);
+            placePiece(engine, rook, rank);
         }
+    }
 
-        // update castling flags
-        if (player == 0) {
-            engine.whiteKingMoved = true;
-        } else {
-            engine.blackKingMoved = true;
+    removePiece(engine, movedPiece, to);
+    placePiece(engine, undo.move.isPromotion() ? pawn : movedPiece, from);
+
+    if (undo.capturedPiece != -1) {
+        int captureSquare = to;
+        if (undo.capturedPiece == (1 - player) * 6 + PAWN && to == undo.enPassantTarget) {
+            captureSquare = player == 0 ? to - 8 : to + 8;
         }
+        placePiece(engine, undo.capturedPiece, captureSquare);
     }
 
-    // update rook moved flags
-    if (move.from == 0) engine.whiteRookA1Moved = true;
-    if (move.from == 7) engine.whiteRookH1Moved = true;
-    if (move.from == 56) engine.blackRookA8Moved = true;
-    if (move.from == 63) engine.blackRookH8Moved = true;
+    // the piece moves above touched the hash, but it is restored wholesale along with the other state
+    engine.hash = undo.hash;
+    engine.sideToMove = player;
+    engine.enPassantTarget = undo.enPassantTarget;
+    engine.halfMoveClock = undo.halfMoveClock;
+    engine.whiteKingMoved = undo.castlingFlags & 1;
+    engine.whiteRookA1Moved = undo.castlingFlags & 2;
+    engine.whiteRookH1Moved = undo.castlingFlags & 4;
+    engine.blackKingMoved = undo.castlingFlags & 8;
+    engine.blackRookA8Moved = undo.castlingFlags & 16;
+    engine.blackRookH8Moved = undo.castlingFlags & 32;
+}
+
+void MoveExecutor::makeNullMove(ChessEngine& engine, int player, UndoRecord& undo) {
+    undo.move = PackedMove();
+    undo.capturedPiece = -1;
+    undo.hash = engine.hash;
+    undo.enPassantTarget = static_cast<int8_t>(engine.enPassantTarget);
+    undo.halfMoveClock = engine.halfMoveClock;
+
+    engine.hash ^= engine.enPassantHash() ^ Zobrist::side();
+    engine.enPassantTarget = -1;
+    engine.halfMoveClock = 0;
+    engine.sideToMove = 1 - player;
 }
 
-void MoveExecutor::removePiece(uint64_t& bitboard, int square) {
-    bitboard &= ~(1ULL << square);
+void MoveExecutor::unmakeNullMove(ChessEngine& engine, const UndoRecord& undo, int player) {
+    engine.hash = undo.hash;
+    engine.sideToMove = player;
+    engine.enPassantTarget = undo.enPassantTarget;
+    engine.halfMoveClock = undo.halfMoveClock;
 }
 
-void MoveExecutor::placePiece(uint64_t& bitboard, int square) {
-    bitboard |= (1ULL << square);
-}
\ No newline at end of file
+void MoveExecutor::removePiece(ChessEngine& engine, int piece, int square) {
+    uint64_t bit = 1ULL << square;
+    engine.bitboards[piece / 6][piece % 6] &= ~bit;
+    engine.occupancy[piece / 6] &= ~bit;
+    engine.occupancy[ALL] &= ~bit;
+    engine.pieceOn[square] = -1;
+    engine.hash ^= Zobrist::piece(piece, square);
+    engine.middlegameScore -= Evaluation::middlegame(piece, square);
+    engine.endgameScore -= Evaluation::endgame(piece, square);
+    engine.gamePhase -= Evaluation::phase(piece);
+}
+
+void MoveExecutor::placePiece(ChessEngine& engine, int piece, int square) {
+    uint64_t bit = 1ULL << square;
+    engine.bitboards[piece / 6][piece % 6] |= bit;
+    engine.occupancy[piece / 6] |= bit;
+    engine.occupancy[ALL] |= bit;
+    engine.pieceOn[square] = static_cast<int8_t>(piece);
+    engine.hash ^= Zobrist::piece(piece, square);
+    engine.middlegameScore += Evaluation::middlegame(piece, square);
+    engine.endgameScore += Evaluation::endgame(piece, square);
+    engine.gamePhase += Evaluation::phase(piece);
+}
@@ -3,6 +3,18 @@
 
 #include "chessengine.hpp"
 
+/**
+ * @brief The state a move destroys, recorded by MoveExecutor::makeMove so MoveExecutor::unmakeMove can take it back.
+ */
+struct UndoRecord {
+    PackedMove move;
+    int8_t capturedPiece;   // captured piece (player * 6 + type), -1 if nothing was captured
+    int8_t enPassantTarget; // en passant target before the move
+    uint8_t castlingFlags;  // king and rook moved flags before the move, one bit each
+    int halfMoveClock;      // half-move clock before the move
+    uint64_t hash;          // Zobrist hash before the move
+};
+
 /**
  * @class MoveExecutor
  * @brief Executes moves on the chessboard for a given player.
@@ -17,20 +29,67 @@ public:
      */
     static void makeMove(ChessEngine& engine, const Move& move, int player);
 
+    /**
+     * @brief Executes a move on the chessboard for the specified player.
+     * @param engine The chess engine containing the game state.
+     * @param move The move to be executed.
+     * @param player The player making the move (0 for white, 1 for black).
+     */
+    static void makeMove(ChessEngine& engine, PackedMove move, int player);
+
+    /**
+     * @brief Executes a move and records what is needed to take it back, so a search can walk the tree in place
+     * instead of copying the engine for every child.
+     * @param engine The chess engine containing the game state.
+     * @param move The move to be executed.
+     * @param player The player making the move (0 for white, 1 for black).
+     * @param undo Receives the state the move overwrites, left untouched if the move is refused.
+     * @return true If the move was made.
+     * @return false If the origin square holds no piece of the player, in which case nothing changes.
+     */
+    static bool makeMove(ChessEngine& engine, PackedMove move, int player, UndoRecord& undo);
+
+    /**
+     * @brief Takes back the move recorded in the undo record, restoring the board and every state flag.
+     * @param engine The chess engine containing the game state.
+     * @param undo The record filled when the move was made.
+     * @param player The player who made the move (0 for white, 1 for black).
+     */
+    static void unmakeMove(ChessEngine& engine, const UndoRecord& undo, int player);
+
+    /**
+     * @brief Passes the turn without moving a piece, for null-move pruning in the search. The en passant target is
+     * cleared and the half-move clock restarts, so positions before the null move never count as repetitions.
+     * @param engine The chess engine containing the game state.
+     * @param player The player passing (0 for white, 1 for black).
+     * @param undo Receives the state the null move overwrites.
+     */
+    static void makeNullMove(ChessEngine& engine, int player, UndoRecord& undo);
+
+    /**
+     * @brief Takes back a null move.
+     * @param engine The chess engine containing the game state.
+     * @param undo The record filled when the null move was made.
+     * @param player The player who passed (0 for white, 1 for black).
+     */
+    static void unmakeNullMove(ChessEngine& engine, const UndoRecord& undo, int player);
+
 private:
     /**
-     * @brief Removes a piece from the specified bitboard at the given square.
-     * @param bitboard The bitboard from which the piece is to be removed.
+     * @brief Removes a piece from the given square, clearing it in the piece, occupancy and mailbox boards and taking its key out of the hash and its scores out of the evaluation.
+     * @param engine The chess engine containing the game state.
+     * @param piece The piece index (0-11).
      * @param square The square index (0-63) from which the piece is to be removed.
      */
-    static void removePiece(uint64_t& bitboard, int square);
+    static void removePiece(ChessEngine& engine, int piece, int square);
 
     /**
-     * @brief Places a piece on the specified bitboard at the given square.
-     * @param bitboard The bitboard on which the piece is to be placed.
+     * @brief Places a piece on the given square, setting it in the piece, occupancy and mailbox boards and adding its key to the hash and its scores to the evaluation.
+     * @param engine The chess engine containing the game state.
+     * @param piece The piece index (0-11).
      * @param square The square index (0-63) on which the piece is to be placed.
      */
-    static void placePiece(uint64_t& bitboard, int square);
+    static void placePiece(ChessEngine& engine, int piece, int square);
 };
 
 #endif // MOVEEXECUTOR_HPP
\ No newline at end of file
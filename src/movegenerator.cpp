@@ -1,224 +1,400 @@
 #include "movegenerator.hpp"
 #include "movevalidator.hpp"
-#include "utils.hpp"
-#include <unordered_set>
+#include "attacks.hpp"
 
-std::vector<Move> MoveGenerator::generateAllValidMoves(const ChessEngine& engine, int player) {
-    std::vector<Move> allMoves = generateAllMoves(engine, player);
+template <bool capturesOnly, typename Emit>
+bool MoveGenerator::generateLegalMoves(const ChessEngine& engine, int player, Emit emit) {
+    const uint64_t* own = engine.bitboards[player];
+    const uint64_t* opponent = engine.bitboards[1 - player];
+    uint64_t pawns = own[PAWN];
+    uint64_t knights = own[KNIGHT];
+    uint64_t diagonalSliders = own[BISHOP] | own[QUEEN];
+    uint64_t straightSliders = own[ROOK] | own[QUEEN];
+    uint64_t king = own[KING];
+    uint64_t ownPieces = engine.occupancy[player];
+    uint64_t opponentPieces = engine.occupancy[1 - player];
+    uint64_t opponentDiagonalSliders = opponent[BISHOP] | opponent[QUEEN];
+    uint64_t opponentStraightSliders = opponent[ROOK] | opponent[QUEEN];
+    uint64_t occupied = engine.occupancy[ALL];
 
-    for (auto it = allMoves.begin(); it != allMoves.end();) {
-        if (!MoveValidator::isValidMove(*it, player, engine)) {
-            it = allMoves.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    // squares the pieces may move to, before checks and pins are taken into account
+    uint64_t targetMask = capturesOnly ? opponentPieces : ~ownPieces;
 
-    return allMoves;
-}
+    if (!king) {
+        return false;
+    }
+    int kingSquare = __builtin_ctzll(king);
 
-std::vector<Move> MoveGenerator::generateAllMoves(const ChessEngine& engine, int player) {
-    std::unordered_set<std::string> uniqueMoves;
-    std::vector<Move> allMoves;
-
-    std::vector<Move> pawnMoves = generatePawnMoves(engine, player);
-    std::vector<Move> knightMoves = generateKnightMoves(engine, player);
-    std::vector<Move> bishopMoves = generateBishopMoves(engine, player);
-    std::vector<Move> rookMoves = generateRookMoves(engine, player);
-    std::vector<Move> queenMoves = generateQueenMoves(engine, player);
-    std::vector<Move> kingMoves = generateKingMoves(engine, player);
-
-    auto addUniqueMoves = [&](const std::vector<Move>& moves) {
-        for (const auto& move : moves) {
-            std::string moveNotation = Utils::positionToUCI(move.from) + Utils::positionToUCI(move.to) + move.promotion;
-            if (uniqueMoves.find(moveNotation) == uniqueMoves.end()) {
-                uniqueMoves.insert(moveNotation);
-                allMoves.push_back(move);
+    // king moves: the destination must not be attacked once the king has left its square,
+    // otherwise a slider checking along the line would seem to be blocked by the king itself
+    uint64_t kingTargets = Attacks::kingAttacks(kingSquare) & targetMask;
+    while (kingTargets) {
+        int targetSquare = __builtin_ctzll(kingTargets);
+        kingTargets &= kingTargets - 1;
+        if (!(MoveValidator::attackersTo(engine, targetSquare, occupied ^ king) & opponentPieces)) {
+            if (emit(PackedMove(kingSquare, targetSquare))) {
+                return true;
             }
         }
-    };
+    }
 
-    addUniqueMoves(pawnMoves);
-    addUniqueMoves(knightMoves);
-    addUniqueMoves(bishopMoves);
-    addUniqueMoves(rookMoves);
-    addUniqueMoves(queenMoves);
-    addUniqueMoves(kingMoves);
+    uint64_t checkers = MoveValidator::attackersTo(engine, kingSquare, occupied) & opponentPieces;
 
-    return allMoves;
-}
+    // in double check only the king can move
+    if (checkers & (checkers - 1)) {
+        return false;
+    }
 
-std::vector<Move> MoveGenerator::generatePawnMoves(const ChessEngine& engine, int player) {
-    std::vector<Move> moves;
-    uint64_t pawns = player == 0 ? engine.whitePawns : engine.blackPawns;
-    uint64_t ownPieces = player == 0 ? (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing)
-                                     : (engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
-    uint64_t opponentPieces = player == 0 ? (engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing)
-                                          : (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing);
-    int enPassantTarget = engine.getEnPassantTarget();
+    // in single check every other piece has to capture the checker or block the line, otherwise anything goes
+    uint64_t evasionMask = ~0ULL;
+    if (checkers) {
+        int checkerSquare = __builtin_ctzll(checkers);
+        evasionMask = checkers | Attacks::between(kingSquare, checkerSquare);
+    }
 
-    for (int square = 0; square < 64; ++square) {
-        if (pawns & (1ULL << square)) {
-            for (int direction : {8, 16, 7, 9}) {
-                int targetSquare = square + (player == 0 ? direction : -direction);
-                if (engine.isWithinBoard(targetSquare)) {
-                    Move move(Utils::positionToUCI(square) + Utils::positionToUCI(targetSquare));
-                    if (MoveValidator::isValidPawnMove(move, player, pawns, opponentPieces, enPassantTarget)) {
-                        if ((player == 0 && targetSquare >= 56) || (player == 1 && targetSquare <= 7)) {
-                            for (char promotion : {'q', 'r', 'b', 'n'}) {
-                                Move promotionMove(Utils::positionToUCI(square) + Utils::positionToUCI(targetSquare) + promotion);
-                                moves.push_back(promotionMove);
-                            }
-                        } else {
-                            moves.push_back(move);
-                        }
-                    }
-                }
+    // castling (the validator refuses castling out of, through or into check)
+    if (!capturesOnly && !checkers) {
+        if (MoveValidator::canCastleKingside(player, engine)) {
+            if (emit(PackedMove(kingSquare, kingSquare + 2))) {
+                return true;
+            }
+        }
+        if (MoveValidator::canCastleQueenside(player, engine)) {
+            if (emit(PackedMove(kingSquare, kingSquare - 2))) {
+                return true;
             }
         }
     }
 
-    return moves;
-}
+    // a piece is pinned if it is the only piece between the king and an opponent slider looking at it
+    uint64_t pinned = 0;
+    uint64_t snipers = (Attacks::rookAttacks(kingSquare, opponentPieces) & opponentStraightSliders) |
+                       (Attacks::bishopAttacks(kingSquare, opponentPieces) & opponentDiagonalSliders);
+    while (snipers) {
+        int sniperSquare = __builtin_ctzll(snipers);
+        snipers &= snipers - 1;
+        uint64_t blockers = Attacks::between(kingSquare, sniperSquare) & occupied;
+        if (blockers && !(blockers & (blockers - 1))) {
+            pinned |= blockers & ownPieces;
+        }
+    }
 
-std::vector<Move> MoveGenerator::generateKnightMoves(const ChessEngine& engine, int player) {
-    std::vector<Move> moves;
-    uint64_t knights = player == 0 ? engine.whiteKnights : engine.blackKnights;
-    uint64_t ownPieces = player == 0 ? (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing)
-                                     : (engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
-
-    for (int square = 0; square < 64; ++square) {
-        if (knights & (1ULL << square)) {
-            for (int offset : {6, 10, 15, 17, -6, -10, -15, -17}) {
-                int targetSquare = square + offset;
-                if (engine.isWithinBoard(targetSquare)) {
-                    Move move(Utils::positionToUCI(square) + Utils::positionToUCI(targetSquare));
-                    if (MoveValidator::isValidKnightMove(move, player, knights, ownPieces)) {
-                        moves.push_back(move);
-                    }
-                }
+    // pinned pieces may only move along the line through the king
+    auto legalTargets = [&](int square, uint64_t targets) {
+        targets &= evasionMask;
+        if (pinned & (1ULL << square)) {
+            targets &= Attacks::line(kingSquare, square);
+        }
+        return targets;
+    };
+
+    auto addMoves = [&](int square, uint64_t targets) {
+        while (targets) {
+            int targetSquare = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            if (emit(PackedMove(square, targetSquare))) {
+                return true;
             }
         }
-    }
+        return false;
+    };
 
-    return moves;
-}
+    int enPassantTarget = engine.getEnPassantTarget();
+    int forward = player == 0 ? 8 : -8;
+    while (pawns) {
+        int square = __builtin_ctzll(pawns);
+        pawns &= pawns - 1;
 
-std::vector<Move> MoveGenerator::generateBishopMoves(const ChessEngine& engine, int player) {
-    std::vector<Move> moves;
-    uint64_t bishops = player == 0 ? engine.whiteBishops : engine.blackBishops;
-    uint64_t ownPieces = player == 0 ? (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing)
-                                     : (engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
-    uint64_t occupied = (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing |
-                         engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
-
-    for (int square = 0; square < 64; ++square) {
-        if (bishops & (1ULL << square)) {
-            for (int direction : {9, 7, -9, -7}) {
-                int targetSquare = square + direction;
-                while (engine.isWithinBoard(targetSquare) && abs((targetSquare % 8) - (square % 8)) == abs((targetSquare / 8) - (square / 8))) {
-                    Move move(Utils::positionToUCI(square) + Utils::positionToUCI(targetSquare));
-                    if (MoveValidator::isValidBishopMove(move, player, bishops, ownPieces, occupied)) {
-                        moves.push_back(move);
+        uint64_t targets = 0;
+        uint64_t singleStep = 1ULL << (square + forward);
+        bool promotes = square / 8 == (player == 0 ? 6 : 1);
+        if (!(singleStep & occupied) && (!capturesOnly || promotes)) {
+            targets |= singleStep;
+            if (!capturesOnly && square / 8 == (player == 0 ? 1 : 6) && !((1ULL << (square + 2 * forward)) & occupied)) {
+                targets |= 1ULL << (square + 2 * forward);
+            }
+        }
+        targets |= Attacks::pawnAttacks(player, square) & opponentPieces;
+        targets = legalTargets(square, targets);
+
+        while (targets) {
+            int targetSquare = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            if (promotes) {
+                for (int promotion : {PackedMove::PROMOTE_QUEEN, PackedMove::PROMOTE_ROOK, PackedMove::PROMOTE_BISHOP, PackedMove::PROMOTE_KNIGHT}) {
+                    if (emit(PackedMove(square, targetSquare, promotion))) {
+                        return true;
                     }
-                    if (occupied & (1ULL << targetSquare)) {
+                    // underpromotions are quiet enough to leave to the full-width search
+                    if (capturesOnly) {
                         break;
                     }
-                    targetSquare += direction;
                 }
+            } else {
+                if (emit(PackedMove(square, targetSquare))) {
+                    return true;
+                }
+            }
+        }
+
+        // en passant removes two pieces from the same rank, which can uncover a check the pin mask cannot see,
+        // so it is verified against the resulting occupancy directly
+        if (enPassantTarget != -1 && (Attacks::pawnAttacks(player, square) & (1ULL << enPassantTarget))) {
+            uint64_t capturedBit = 1ULL << (enPassantTarget - forward);
+            uint64_t occupiedAfter = (occupied ^ (1ULL << square) ^ capturedBit) | (1ULL << enPassantTarget);
+            if (!(MoveValidator::attackersTo(engine, kingSquare, occupiedAfter) & opponentPieces & ~capturedBit)) {
+                if (emit(PackedMove(square, enPassantTarget))) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    while (knights) {
+        int square = __builtin_ctzll(knights);
+        knights &= knights - 1;
+        // a pinned knight can never stay on the line
+        if (!(pinned & (1ULL << square))) {
+            if (addMoves(square, Attacks::knightAttacks(square) & targetMask & evasionMask)) {
+                return true;
             }
         }
     }
 
-    return moves;
+    while (diagonalSliders) {
+        int square = __builtin_ctzll(diagonalSliders);
+        diagonalSliders &= diagonalSliders - 1;
+        if (addMoves(square, legalTargets(square, Attacks::bishopAttacks(square, occupied) & targetMask))) {
+            return true;
+        }
+    }
+
+    while (straightSliders) {
+        int square = __builtin_ctzll(straightSliders);
+        straightSliders &= straightSliders - 1;
+        if (addMoves(square, legalTargets(square, Attacks::rookAttacks(square, occupied) & targetMask))) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
-std::vector<Move> MoveGenerator::generateRookMoves(const ChessEngine& engine, int player) {
-    std::vector<Move> moves;
-    uint64_t rooks = player == 0 ? engine.whiteRooks : engine.blackRooks;
-    uint64_t ownPieces = player == 0 ? (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing)
-                                     : (engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
-    uint64_t occupied = (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing |
-                         engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
-
-    for (int square = 0; square < 64; ++square) {
-        if (rooks & (1ULL << square)) {
-            for (int direction : {8, -8, 1, -1}) {
-                for (int i = square + direction; i >= 0 && i < 64; i += direction) {
-                    if (!engine.isWithinBoard(i)) break;
-                    Move move(Utils::positionToUCI(square) + Utils::positionToUCI(i));
-                    if (MoveValidator::isValidRookMove(move, player, rooks, ownPieces, occupied)) {
-                        moves.push_back(move);
-                    }
-                    if (occupied & (1ULL << i)) {
-                        break;
-                    }
+void MoveGenerator::generateAllValidMoves(const ChessEngine& engine, int player, MoveList& moves) {
+    generateLegalMoves<false>(engine, player, [&moves](PackedMove move) {
+        moves.push_back(move);
+        return false;
+    });
+}
+
+bool MoveGenerator::hasAnyLegalMove(const ChessEngine& engine, int player) {
+    return generateLegalMoves<false>(engine, player, [](PackedMove) {
+        return true;
+    });
+}
+
+void MoveGenerator::generateCaptures(const ChessEngine& engine, int player, MoveList& moves) {
+    generateLegalMoves<true>(engine, player, [&moves](PackedMove move) {
+        moves.push_back(move);
+        return false;
+    });
+}
+
+void MoveGenerator::generateAllMoves(const ChessEngine& engine, int player, MoveList& moves) {
+    generatePawnMoves(engine, player, moves);
+    generateKnightMoves(engine, player, moves);
+    generateBishopMoves(engine, player, moves);
+    generateRookMoves(engine, player, moves);
+    generateQueenMoves(engine, player, moves);
+    generateKingMoves(engine, player, moves);
+}
+
+void MoveGenerator::generatePawnMoves(const ChessEngine& engine, int player, MoveList& moves) {
+    uint64_t pawns = engine.bitboards[player][PAWN];
+    uint64_t opponentPieces = engine.occupancy[1 - player];
+    uint64_t occupied = engine.occupancy[ALL];
+    int enPassantTarget = engine.getEnPassantTarget();
+    uint64_t captureTargets = opponentPieces | (enPassantTarget != -1 ? 1ULL << enPassantTarget : 0);
+    int forward = player == 0 ? 8 : -8;
+
+    while (pawns) {
+        int square = __builtin_ctzll(pawns);
+        pawns &= pawns - 1;
+
+        // pushes: one step if empty, two steps from the starting rank if both squares are empty
+        uint64_t targets = 0;
+        uint64_t singleStep = 1ULL << (square + forward);
+        if (!(singleStep & occupied)) {
+            targets |= singleStep;
+            if (square / 8 == (player == 0 ? 1 : 6) && !((1ULL << (square + 2 * forward)) & occupied)) {
+                targets |= 1ULL << (square + 2 * forward);
+            }
+        }
+        targets |= Attacks::pawnAttacks(player, square) & captureTargets;
+
+        while (targets) {
+            int targetSquare = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            if ((player == 0 && targetSquare >= 56) || (player == 1 && targetSquare <= 7)) {
+                for (int promotion : {PackedMove::PROMOTE_QUEEN, PackedMove::PROMOTE_ROOK, PackedMove::PROMOTE_BISHOP, PackedMove::PROMOTE_KNIGHT}) {
+                    moves.push_back(PackedMove(square, targetSquare, promotion));
                 }
+            } else {
+                moves.push_back(PackedMove(square, targetSquare));
             }
         }
     }
+}
 
-    return moves;
+void MoveGenerator::generateKnightMoves(const ChessEngine& engine, int player, MoveList& moves) {
+    uint64_t knights = engine.bitboards[player][KNIGHT];
+    uint64_t ownPieces = engine.occupancy[player];
+
+    while (knights) {
+        int square = __builtin_ctzll(knights);
+        knights &= knights - 1;
+
+        uint64_t targets = Attacks::knightAttacks(square) & ~ownPieces;
+        while (targets) {
+            int targetSquare = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            moves.push_back(PackedMove(square, targetSquare));
+        }
+    }
 }
 
-std::vector<Move> MoveGenerator::generateQueenMoves(const ChessEngine& engine, int player) {
-    std::vector<Move> moves;
-    uint64_t queens = player == 0 ? engine.whiteQueens : engine.blackQueens;
-    uint64_t ownPieces = player == 0 ? (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing)
-                                     : (engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
-    uint64_t occupied = (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing |
-                         engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
-
-    for (int square = 0; square < 64; ++square) {
-        if (queens & (1ULL << square)) {
-            // queen moves like both rooks and bishops
-            for (int direction : {9, 7, -9, -7, 8, -8, 1, -1}) {
-                for (int i = square + direction; i >= 0 && i < 64; i += direction) {
-                    if (!engine.isWithinBoard(i)) break;
-                    Move move(Utils::positionToUCI(square) + Utils::positionToUCI(i));
-                    if (MoveValidator::isValidQueenMove(move, player, queens, ownPieces, occupied)) {
-                        moves.push_back(move);
-                    }
-                    if (occupied & (1ULL << i)) {
-                        break;
-                    }
-                }
-            }
+void MoveGenerator::generateBishopMoves(const ChessEngine& engine, int player, MoveList& moves) {
+    uint64_t bishops = engine.bitboards[player][BISHOP];
+    uint64_t ownPieces = engine.occupancy[player];
+    uint64_t occupied = engine.occupancy[ALL];
+
+    while (bishops) {
+        int square = __builtin_ctzll(bishops);
+        bishops &= bishops - 1;
+
+        uint64_t targets = Attacks::bishopAttacks(square, occupied) & ~ownPieces;
+        while (targets) {
+            int targetSquare = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            moves.push_back(PackedMove(square, targetSquare));
         }
     }
+}
+
+void MoveGenerator::generateRookMoves(const ChessEngine& engine, int player, MoveList& moves) {
+    uint64_t rooks = engine.bitboards[player][ROOK];
+    uint64_t ownPieces = engine.occupancy[player];
+    uint64_t occupied = engine.occupancy[ALL];
 
-    return moves;
+    while (rooks) {
+        int square = __builtin_ctzll(rooks);
+        rooks &= rooks - 1;
+
+        uint64_t targets = Attacks::rookAttacks(square, occupied) & ~ownPieces;
+        while (targets) {
+            int targetSquare = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            moves.push_back(PackedMove(square, targetSquare));
+        }
+    }
 }
 
-std::vector<Move> MoveGenerator::generateKingMoves(const ChessEngine& engine, int player) {
-    std::vector<Move> moves;
-    uint64_t king = player == 0 ? engine.whiteKing : engine.blackKing;
-    uint64_t ownPieces = player == 0 ? (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing)
-                                     : (engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
-
-    for (int square = 0; square < 64; ++square) {
-        if (king & (1ULL << square)) {
-            for (int offset : {8, -8, 1, -1, 9, 7, -9, -7}) {
-                int targetSquare = square + offset;
-                if (engine.isWithinBoard(targetSquare)) {
-                    Move move(Utils::positionToUCI(square) + Utils::positionToUCI(targetSquare));
-                    if (MoveValidator::isValidKingMove(move, player, king, ownPieces)) {
-                        moves.push_back(move);
-                    }
-                }
-            }
+void MoveGenerator::generateQueenMoves(const ChessEngine& engine, int player, MoveList& moves) {
+    uint64_t queens = engine.bitboards[player][QUEEN];
+    uint64_t ownPieces = engine.occupancy[player];
+    uint64_t occupied = engine.occupancy[ALL];
 
-            // castling
-            if (MoveValidator::canCastleKingside(player, engine)) {
-                Move kingsideCastle(Utils::positionToUCI(square) + Utils::positionToUCI(square + 2));
-                moves.push_back(kingsideCastle);
-            }
-            if (MoveValidator::canCastleQueenside(player, engine)) {
-                Move queensideCastle(Utils::positionToUCI(square) + Utils::positionToUCI(square - 2));
-                moves.push_back(queensideCastle);
-            }
+    while (queens) {
+        int square = __builtin_ctzll(queens);
+        queens &= queens - 1;
+
+        // queen moves like both rooks and bishops
+        uint64_t targets = Attacks::queenAttacks(square, occupied) & ~ownPieces;
+        while (targets) {
+            int targetSquare = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            moves.push_back(PackedMove(square, targetSquare));
+        }
+    }
+}
+
+void MoveGenerator::generateKingMoves(const ChessEngine& engine, int player, MoveList& moves) {
+    uint64_t king = engine.bitboards[player][KING];
+    uint64_t ownPieces = engine.occupancy[player];
+
+    if (king) {
+        int square = __builtin_ctzll(king);
+
+        uint64_t targets = Attacks::kingAttacks(square) & ~ownPieces;
+        while (targets) {
+            int targetSquare = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            moves.push_back(PackedMove(square, targetSquare));
+        }
+
+        // castling
+        if (MoveValidator::canCastleKingside(player, engine)) {
+            moves.push_back(PackedMove(square, square + 2));
+        }
+        if (MoveValidator::canCastleQueenside(player, engine)) {
+            moves.push_back(PackedMove(square, square - 2));
         }
     }
+}
+
+std::vector<Move> MoveGenerator::generateAllValidMoves(const ChessEngine& engine, int player) {
+    MoveList moves;
+    generateAllValidMoves(engine, player, moves);
+    return toMoveVector(moves);
+}
+
+std::vector<Move> MoveGenerator::generateAllMoves(const ChessEngine& engine, int player) {
+    MoveList moves;
+    generateAllMoves(engine, player, moves);
+    return toMoveVector(moves);
+}
+
+std::vector<Move> MoveGenerator::generatePawnMoves(const ChessEngine& engine, int player) {
+    MoveList moves;
+    generatePawnMoves(engine, player, moves);
+    return toMoveVector(moves);
+}
+
+std::vector<Move> MoveGenerator::generateKnightMoves(const ChessEngine& engine, int player) {
+    MoveList moves;
+    generateKnightMoves(engine, player, moves);
+    return toMoveVector(moves);
+}
+
+std::vector<Move> MoveGenerator::generateBishopMoves(const ChessEngine& engine, int player) {
+    MoveList moves;
+    generateBishopMoves(engine, player, moves);
+    return toMoveVector(moves);
+}
+
+std::vector<Move> MoveGenerator::generateRookMoves(const ChessEngine& engine, int player) {
+    MoveList moves;
+    generateRookMoves(engine, player, moves);
+    return toMoveVector(moves);
+}
 
-    return moves;
-}
\ No newline at end of file
+std::vector<Move> MoveGenerator::generateQueenMoves(const ChessEngine& engine, int player) {
+    MoveList moves;
+    generateQueenMoves(engine, player, moves);
+    return toMoveVector(moves);
+}
+
+std::vector<Move> MoveGenerator::generateKingMoves(const ChessEngine& engine, int player) {
+    MoveList moves;
+    generateKingMoves(engine, player, moves);
+    return toMoveVector(moves);
+}
+
+std::vector<Move> MoveGenerator::toMoveVector(const MoveList& moves) {
+    std::vector<Move> result;
+    result.reserve(moves.size());
+    for (PackedMove move : moves) {
+        result.push_back(Move(move));
+    }
+    return result;
+}
@@ -5,6 +5,7 @@
 #include "chessengine.hpp"
 
 class Move;
+struct MoveList;
 class ChessEngine;
 
 /**
@@ -21,6 +22,14 @@ public:
      */
     static std::vector<Move> generateAllMoves(const ChessEngine& engine, int player);
 
+    /**
+     * @brief Generates all possible moves for the specified player into a caller-provided list.
+     * @param engine The chess engine containing the game state.
+     * @param player The player for whom moves are to be generated (0 for white, 1 for black).
+     * @param moves The list the moves are appended to.
+     */
+    static void generateAllMoves(const ChessEngine& engine, int player, MoveList& moves);
+
     /**
      * @brief Generates all valid moves for the specified player, excluding moves that leave the king in check.
      * @param engine The chess engine containing the game state.
@@ -29,6 +38,34 @@ public:
      */
     static std::vector<Move> generateAllValidMoves(const ChessEngine& engine, int player);
 
+    /**
+     * @brief Generates all valid moves for the specified player into a caller-provided list, excluding moves that leave the king in check.
+     * Checkers and pinned pieces are computed once per position, so only legal moves are ever emitted.
+     * @param engine The chess engine containing the game state.
+     * @param player The player for whom valid moves are to be generated (0 for white, 1 for black).
+     * @param moves The list the moves are appended to.
+     */
+    static void generateAllValidMoves(const ChessEngine& engine, int player, MoveList& moves);
+
+    /**
+     * @brief Checks whether the specified player has at least one legal move, stopping at the first one found.
+     * @param engine The chess engine containing the game state.
+     * @param player The player to check (0 for white, 1 for black).
+     * @return true If the player has a legal move.
+     * @return false If the player is checkmated or stalemated.
+     */
+    static bool hasAnyLegalMove(const ChessEngine& engine, int player);
+
+    /**
+     * @brief Generates the legal captures (including en passant) and queen promotions of the specified player into a
+     * caller-provided list. Quiet moves are never produced, rather than generated and filtered out, which keeps the
+     * quiescence search cheap.
+     * @param engine The chess engine containing the game state.
+     * @param player The player for whom captures are to be generated (0 for white, 1 for black).
+     * @param moves The list the moves are appended to.
+     */
+    static void generateCaptures(const ChessEngine& engine, int player, MoveList& moves);
+
     /**
      * @brief Generates all possible pawn moves for the specified player.
      * @param engine The chess engine containing the game state.
@@ -37,6 +74,14 @@ public:
      */
     static std::vector<Move> generatePawnMoves(const ChessEngine& engine, int player);
 
+    /**
+     * @brief Generates all possible pawn moves for the specified player into a caller-provided list.
+     * @param engine The chess engine containing the game state.
+     * @param player The player for whom pawn moves are to be generated (0 for white, 1 for black).
+     * @param moves The list the moves are appended to.
+     */
+    static void generatePawnMoves(const ChessEngine& engine, int player, MoveList& moves);
+
     /**
      * @brief Generates all possible knight moves for the specified player.
      * @param engine The chess engine containing the game state.
@@ -45,6 +90,14 @@ public:
      */
     static std::vector<Move> generateKnightMoves(const ChessEngine& engine, int player);
 
+    /**
+     * @brief Generates all possible knight moves for the specified player into a caller-provided list.
+     * @param engine The chess engine containing the game state.
+     * @param player The player for whom knight moves are to be generated (0 for white, 1 for black).
+     * @param moves The list the moves are appended to.
+     */
+    static void generateKnightMoves(const ChessEngine& engine, int player, MoveList& moves);
+
     /**
      * @brief Generates all possible bishop moves for the specified player.
      * @param engine The chess engine containing the game state.
@@ -53,6 +106,14 @@ public:
      */
     static std::vector<Move> generateBishopMoves(const ChessEngine& engine, int player);
 
+    /**
+     * @brief Generates all possible bishop moves for the specified player into a caller-provided list.
+     * @param engine The chess engine containing the game state.
+     * @param player The player for whom bishop moves are to be generated (0 for white, 1 for black).
+     * @param moves The list the moves are appended to.
+     */
+    static void generateBishopMoves(const ChessEngine& engine, int player, MoveList& moves);
+
     /**
      * @brief Generates all possible rook moves for the specified player.
      * @param engine The chess engine containing the game state.
@@ -61,6 +122,14 @@ public:
      */
     static std::vector<Move> generateRookMoves(const ChessEngine& engine, int player);
 
+    /**
+     * @brief Generates all possible rook moves for the specified player into a caller-provided list.
+     * @param engine The chess engine containing the game state.
+     * @param player The player for whom rook moves are to be generated (0 for white, 1 for black).
+     * @param moves The list the moves are appended to.
+     */
+    static void generateRookMoves(const ChessEngine& engine, int player, MoveList& moves);
+
     /**
      * @brief Generates all possible queen moves for the specified player.
      * @param engine The chess engine containing the game state.
@@ -69,6 +138,14 @@ public:
      */
     static std::vector<Move> generateQueenMoves(const ChessEngine& engine, int player);
 
+    /**
+     * @brief Generates all possible queen moves for the specified player into a caller-provided list.
+     * @param engine The chess engine containing the game state.
+     * @param player The player for whom queen moves are to be generated (0 for white, 1 for black).
+     * @param moves The list the moves are appended to.
+     */
+    static void generateQueenMoves(const ChessEngine& engine, int player, MoveList& moves);
+
     /**
      * @brief Generates all possible king moves for the specified player.
      * @param engine The chess engine containing the game state.
@@ -77,12 +154,40 @@ public:
      */
     static std::vector<Move> generateKingMoves(const ChessEngine& engine, int player);
 
+    /**
+     * @brief Generates all possible king moves for the specified player into a caller-provided list.
+     * @param engine The chess engine containing the game state.
+     * @param player The player for whom king moves are to be generated (0 for white, 1 for black).
+     * @param moves The list the moves are appended to.
+     */
+    static void generateKingMoves(const ChessEngine& engine, int player, MoveList& moves);
+
     /**
      * @brief Converts a position index to UCI format.
      * @param position The position index (0-63).
      * @return A string representing the position in UCI format.
      */
     static std::string positionToUCI(int position);
+
+private:
+    /**
+     * @brief Emits the legal moves of the specified player one at a time, king moves first.
+     * @tparam capturesOnly Whether to emit only captures and queen promotions.
+     * @param engine The chess engine containing the game state.
+     * @param player The player for whom valid moves are to be generated (0 for white, 1 for black).
+     * @param emit Called with every legal move; returning true stops the generation.
+     * @return true If the generation was stopped by emit.
+     * @return false If every legal move was emitted.
+     */
+    template <bool capturesOnly, typename Emit>
+    static bool generateLegalMoves(const ChessEngine& engine, int player, Emit emit);
+
+    /**
+     * @brief Converts a move list to the vector form returned by the convenience overloads.
+     * @param moves The list of moves to convert.
+     * @return A vector with the same moves, in the same order.
+     */
+    static std::vector<Move> toMoveVector(const MoveList& moves);
 };
 
 #endif // MOVEGENERATOR_HPP
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "movepicker.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+MovePicker::MovePicker(const ChessEngine& engine, MoveList& moves, PackedMove hashMove, const PackedMove* killers, const int (*history)[64])
+    : engine(engine), moves(moves), hashMove(hashMove), killers(killers), history(history), index(0), hashIndex(-1), scored(false) {}
+
+bool MovePicker::next(PackedMove& move) {
+    if (index >= moves.size()) {
+        return false;
+    }
+
+    // the hash move is handed out before anything is scored
+    if (index == 0 && !scored) {
+        PackedMove* found = std::find(moves.begin(), moves.end(), hashMove);
+        if (found != moves.end()) {
+            std::swap(*found, moves[0]);
+            move = moves[index++];
+            hashIndex = index;
+            return true;
+        }
+    }
+
+    if (!scored) {
+        scoreMoves();
+    }
+
+    // selection pass: bring the best remaining move forward
+    int best = index;
+    for (int i = index + 1; i < moves.size(); ++i) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    std::swap(moves[index], moves[best]);
+    std::swap(scores[index], scores[best]);
+
+    move = moves[index++];
+    return true;
+}
+
+bool MovePicker::isCapture(const ChessEngine& engine, PackedMove move) {
+    if (engine.pieceAt(move.to()) != -1) {
+        return true;
+    }
+    // en passant: a pawn moving onto the en passant target
+    return move.to() == engine.getEnPassantTarget() && engine.pieceAt(move.from()) % 6 == PAWN;
+}
+
+void MovePicker::updateHistory(int (*history)[64], PackedMove move, int depth) {
+    int bonus = std::min(depth * depth, 400);
+    int& entry = history[move.from()][move.to()];
+    entry += bonus - entry * bonus / historyMax;
+}
+
+void MovePicker::scoreMoves() {
+    for (int i = index; i < moves.size(); ++i) {
+        PackedMove move = moves[i];
+        int attacker = engine.pieceAt(move.from()) % 6;
+        int victim = engine.pieceAt(move.to());
+
+        if (victim != -1 || move.flags() == PackedMove::PROMOTE_QUEEN || isCapture(engine, move)) {
+            // most valuable victim first, then least valuable attacker; a queen promotion counts as winning a queen,
+            // and an empty target square is either en passant or a promotion without a capture, both worth a pawn
+            int value = victim != -1 ? victim % 6 : PAWN;
+            if (move.flags() == PackedMove::PROMOTE_QUEEN) {
+                value += QUEEN;
+            }
+            scores[i] = captureScore + 8 * value - attacker;
+        } else if (killers != nullptr && move == killers[0]) {
+            scores[i] = killerScore;
+        } else if (killers != nullptr && move == killers[1]) {
+            scores[i] = killerScore - 1;
+        } else {
+            scores[i] = history != nullptr ? history[move.from()][move.to()] : 0;
+        }
+    }
+    scored = true;
+}
@@ -0,0 +1,91 @@
+#ifndef MOVEPICKER_HPP
+#define MOVEPICKER_HPP
+
+#include "chessengine.hpp"
+
+/**
+ * @class MovePicker
+ * @brief Hands out the moves of a generated list best first, for the search. The hash move comes first without any
+ * scoring; only when the search asks for a second move are the others scored: captures and queen promotions by
+ * MVV-LVA (most valuable victim, least valuable attacker), then the killer moves, then the remaining quiet moves by
+ * the history table. Each following move is picked by a single selection pass, so a node that is cut off after a few
+ * moves never sorts the whole list.
+ */
+class MovePicker {
+public:
+    static const int historyMax = 16384; // bound of the history table entries, below every killer and capture score
+    static const int captureScore = 1 << 20;          // base score of captures and queen promotions
+    static const int killerScore = captureScore - 2;  // score of the first killer move, the second one scores one less
+    static const int hashScore = 2 * captureScore;    // above every other score
+
+    /**
+     * @brief Constructor for the MovePicker class.
+     * @param engine The position the moves were generated in.
+     * @param moves The moves to pick from, reordered in place.
+     * @param hashMove The move to try first, usually from the transposition table; ignored if it is not in the list.
+     * @param killers The two killer moves of the current ply, or nullptr for none.
+     * @param history The history table of the side to move, indexed by from and to square, or nullptr for none.
+     */
+    MovePicker(const ChessEngine& engine, MoveList& moves, PackedMove hashMove, const PackedMove* killers, const int (*history)[64]);
+
+    /**
+     * @brief Gets the next best move.
+     * @param move Receives the move.
+     * @return true If a move was left.
+     * @return false If all moves have been picked.
+     */
+    bool next(PackedMove& move);
+
+    /**
+     * @brief Gets the ordering score of the move last returned by next, hashScore for the hash move. Scores from
+     * killerScore - 1 up belong to captures, promotions and killers, lower ones are history values.
+     * @return int The score.
+     */
+    int score() const { return index == hashIndex ? hashScore : scores[index - 1]; }
+
+    /**
+     * @brief Checks whether a move captures a piece, including en passant.
+     * @param engine The position the move is played in.
+     * @param move The move.
+     * @return true If the move is a capture.
+     * @return false Otherwise.
+     */
+    static bool isCapture(const ChessEngine& engine, PackedMove move);
+
+    /**
+     * @brief Checks whether a move is quiet, neither a capture nor a promotion. Only quiet moves become killers or
+     * enter the history table.
+     * @param engine The position the move is played in.
+     * @param move The move.
+     * @return true If the move is quiet.
+     * @return false Otherwise.
+     */
+    static bool isQuiet(const ChessEngine& engine, PackedMove move) { return !move.isPromotion() && !isCapture(engine, move); }
+
+    /**
+     * @brief Rewards a quiet move that caused a cutoff in the history table. Entries saturate smoothly at historyMax.
+     * @param history The history table of the side that made the move.
+     * @param move The move.
+     * @param depth The remaining depth of the node, deeper cutoffs count more.
+     */
+    static void updateHistory(int (*history)[64], PackedMove move, int depth);
+
+private:
+    /**
+     * @brief Scores every move not yet picked.
+     */
+    void scoreMoves();
+
+    const ChessEngine& engine;
+    MoveList& moves;
+    PackedMove hashMove;
+    const PackedMove* killers;
+    const int (*history)[64];
+
+    int scores[MoveList::capacity];
+    int index;    // moves before this one have been picked
+    int hashIndex; // index after the hash move was picked, -1 if there was none
+    bool scored;  // whether the remaining moves have been scored
+};
+
+#endif // MOVEPICKER_HPP
@@ -1,55 +1,60 @@
 #include "movevalidator.hpp"
-#include "moveexecutor.hpp"
-#include "movegenerator.hpp"
-#include <iostream>
+#include "attacks.hpp"
 #include "utils.hpp"
 
 bool MoveValidator::isValidMove(const Move& move, int player, const ChessEngine& engine) {
     if (!engine.isWithinBoard(move.from) || !engine.isWithinBoard(move.to)) {
-        std::cout << "Move from " << move.from << " to " << move.to << " is out of bounds" << std::endl;
+        engine.notify(EngineEvent::MOVE_OUT_OF_BOUNDS, PackedMove(), player);
         return false;
     }
 
-    uint64_t fromBit = 1ULL << move.from;
-    uint64_t toBit = 1ULL << move.to;
-
-    uint64_t pawns = player == 0 ? engine.whitePawns : engine.blackPawns;
-    uint64_t knights = player == 0 ? engine.whiteKnights : engine.blackKnights;
-    uint64_t bishops = player == 0 ? engine.whiteBishops : engine.blackBishops;
-    uint64_t rooks = player == 0 ? engine.whiteRooks : engine.blackRooks;
-    uint64_t queens = player == 0 ? engine.whiteQueens : engine.blackQueens;
-    uint64_t king = player == 0 ? engine.whiteKing : engine.blackKing;
-    uint64_t ownPieces = player == 0 ? (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing)
-                                     : (engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
-    uint64_t opponentPieces = player == 0 ? (engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing)
-                                          : (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing);
-    uint64_t occupied = (engine.whitePawns | engine.whiteKnights | engine.whiteBishops | engine.whiteRooks | engine.whiteQueens | engine.whiteKing |
-                         engine.blackPawns | engine.blackKnights | engine.blackBishops | engine.blackRooks | engine.blackQueens | engine.blackKing);
+    return isValidMove(move.toPacked(), player, engine);
+}
+
+bool MoveValidator::isValidMove(PackedMove move, int player, const ChessEngine& engine) {
+    const uint64_t* own = engine.bitboards[player];
+    uint64_t ownPieces = engine.occupancy[player];
+    uint64_t opponentPieces = engine.occupancy[1 - player];
+    uint64_t occupied = engine.occupancy[ALL];
+
+    int piece = engine.pieceAt(move.from());
+    if (piece == -1 || piece / 6 != player) {
+        engine.notify(EngineEvent::NO_PIECE_TO_MOVE, move, player);
+        return false;
+    }
 
     bool valid = false;
-    if (pawns & fromBit) {
-        valid = isValidPawnMove(move, player, ownPieces, opponentPieces, engine.getEnPassantTarget());
-    } else if (knights & fromBit) {
-        valid = isValidKnightMove(move, player, knights, ownPieces);
-    } else if (bishops & fromBit) {
-        valid = isValidBishopMove(move, player, bishops, ownPieces, occupied);
-    } else if (rooks & fromBit) {
-        valid = isValidRookMove(move, player, rooks, ownPieces, occupied);
-    } else if (queens & fromBit) {
-        valid = isValidQueenMove(move, player, queens, ownPieces, occupied);
-    } else if (king & fromBit) {
-        // handle castling
-        if ((move.from == 4 && move.to == 6 && canCastleKingside(player, engine)) ||
-            (move.from == 4 && move.to == 2 && canCastleQueenside(player, engine)) ||
-            (move.from == 60 && move.to == 62 && canCastleKingside(player, engine)) ||
-            (move.from == 60 && move.to == 58 && canCastleQueenside(player, engine))) {
-            return true;
-        }
-        valid = isValidKingMove(move, player, king, ownPieces);
-    } else {
-        std::cout << "No piece at from square" << std::endl;
+    if (move.isPromotion() && piece % 6 != PAWN) {
+        // only pawns promote
         return false;
     }
+    switch (piece % 6) {
+        case PAWN:
+            valid = isValidPawnMove(move, player, ownPieces, opponentPieces, engine.getEnPassantTarget());
+            break;
+        case KNIGHT:
+            valid = isValidKnightMove(move, player, own[KNIGHT], ownPieces);
+            break;
+        case BISHOP:
+            valid = isValidBishopMove(move, player, own[BISHOP], ownPieces, occupied);
+            break;
+        case ROOK:
+            valid = isValidRookMove(move, player, own[ROOK], ownPieces, occupied);
+            break;
+        case QUEEN:
+            valid = isValidQueenMove(move, player, own[QUEEN], ownPieces, occupied);
+            break;
+        default:
+            // handle castling
+            if ((move.from() == 4 && move.to() == 6 && canCastleKingside(player, engine)) ||
+                (move.from() == 4 && move.to() == 2 && canCastleQueenside(player, engine)) ||
+                (move.from() == 60 && move.to() == 62 && canCastleKingside(player, engine)) ||
+                (move.from() == 60 && move.to() == 58 && canCastleQueenside(player, engine))) {
+                return true;
+            }
+            valid = isValidKingMove(move, player, own[KING], ownPieces);
+            break;
+    }
 
     if (valid && !doesMoveExposeKing(move, player, engine)) {
         return true;
@@ -58,194 +63,149 @@ bool MoveValidator::isValidMove(const Move& move, int player, const ChessEngine&
     return false;
 }
 
-bool MoveValidator::isValidPawnMove(const Move& move, int player, uint64_t ownPieces, uint64_t opponentPieces, int enPassantTarget) {
-    uint64_t fromBit = 1ULL << move.from;
-    uint64_t toBit = 1ULL << move.to;
+bool MoveValidator::isValidPawnMove(PackedMove move, int player, uint64_t ownPieces, uint64_t opponentPieces, int enPassantTarget) {
+    uint64_t fromBit = 1ULL << move.from();
+    uint64_t toBit = 1ULL << move.to();
 
     int direction = player == 0 ? 1 : -1;
 
     // single step forward
-    if (move.to == move.from + 8 * direction && !(toBit & (opponentPieces | ownPieces))) {
+    if (move.to() == move.from() + 8 * direction && !(toBit & (opponentPieces | ownPieces))) {
         // promotion check
-        if ((player == 0 && move.to >= 56) || (player == 1 && move.to <= 7)) {
-            return move.promotion == 'q' || move.promotion == 'r' || move.promotion == 'b' || move.promotion == 'n';
+        if ((player == 0 && move.to() >= 56) || (player == 1 && move.to() <= 7)) {
+            return move.isPromotion();
         }
-        return true;
+        return !move.isPromotion();
     }
 
     // double step forward from the starting position
-    if (move.to == move.from + 16 * direction && move.from / 8 == (player == 0 ? 1 : 6) &&
-        !(toBit & (opponentPieces | ownPieces)) && !((1ULL << (move.from + 8 * direction)) & (opponentPieces | ownPieces))) {
-        return true;
+    if (move.to() == move.from() + 16 * direction && move.from() / 8 == (player == 0 ? 1 : 6) &&
+        !(toBit & (opponentPieces | ownPieces)) && !((1ULL << (move.from() + 8 * direction)) & (opponentPieces | ownPieces))) {
+        return !move.isPromotion();
     }
 
     // capture move
-    if ((move.to == move.from + 7 * direction || move.to == move.from + 9 * direction) && (toBit & opponentPieces)) {
+    if ((Attacks::pawnAttacks(player, move.from()) & toBit) && (toBit & opponentPieces)) {
         // promotion check
-        if ((player == 0 && move.to >= 56) || (player == 1 && move.to <= 7)) {
-            return move.promotion == 'q' || move.promotion == 'r' || move.promotion == 'b' || move.promotion == 'n';
+        if ((player == 0 && move.to() >= 56) || (player == 1 && move.to() <= 7)) {
+            return move.isPromotion();
         }
-        return true;
+        return !move.isPromotion();
     }
 
     // en passant move
-    if ((move.to == enPassantTarget) && (move.from + 7 * direction == enPassantTarget || move.from + 9 * direction == enPassantTarget)) {
-        return true;
+    if (enPassantTarget != -1 && move.to() == enPassantTarget && (Attacks::pawnAttacks(player, move.from()) & toBit)) {
+        return !move.isPromotion();
     }
 
     return false;
 }
 
-bool MoveValidator::isValidKnightMove(const Move& move, int player, uint64_t knights, uint64_t ownPieces) {
-    uint64_t fromBit = 1ULL << move.from;
-    uint64_t toBit = 1ULL << move.to;
-
-    int rowDiff = abs((move.from / 8) - (move.to / 8));
-    int colDiff = abs((move.from % 8) - (move.to % 8));
-
-    if ((rowDiff == 2 && colDiff == 1) || (rowDiff == 1 && colDiff == 2)) {
-        if (!(toBit & ownPieces)) {
-            return true;
-        }
-    }
+bool MoveValidator::isValidKnightMove(PackedMove move, int player, uint64_t knights, uint64_t ownPieces) {
+    uint64_t toBit = 1ULL << move.to();
 
-    return false;
+    return (Attacks::knightAttacks(move.from()) & toBit) && !(toBit & ownPieces);
 }
 
-bool MoveValidator::isValidBishopMove(const Move& move, int player, uint64_t bishops, uint64_t ownPieces, uint64_t occupied) {
-    uint64_t fromBit = 1ULL << move.from;
-    uint64_t toBit = 1ULL << move.to;
+bool MoveValidator::isValidBishopMove(PackedMove move, int player, uint64_t bishops, uint64_t ownPieces, uint64_t occupied) {
+    uint64_t toBit = 1ULL << move.to();
 
-    int rowDiff = abs((move.from / 8) - (move.to / 8));
-    int colDiff = abs((move.from % 8) - (move.to % 8));
-
-    if (rowDiff == colDiff) {
-        int direction = (move.to > move.from) ? 1 : -1;
-        int step = (move.to > move.from) ? ((move.to % 8 > move.from % 8) ? 9 : 7) : ((move.to % 8 > move.from % 8) ? -7 : -9);
-
-        for (int i = move.from + step; i != move.to; i += step) {
-            if (occupied & (1ULL << i)) {
-                return false;
-            }
-        }
-
-        if (!(toBit & ownPieces)) {
-            return true;
-        }
-    }
-
-    return false;
+    return (Attacks::bishopAttacks(move.from(), occupied) & toBit) && !(toBit & ownPieces);
 }
 
-bool MoveValidator::isValidRookMove(const Move& move, int player, uint64_t rooks, uint64_t ownPieces, uint64_t occupied) {
-    uint64_t fromBit = 1ULL << move.from;
-    uint64_t toBit = 1ULL << move.to;
-
-    int rowDiff = abs((move.from / 8) - (move.to / 8));
-    int colDiff = abs((move.from % 8) - (move.to % 8));
-
-    if (rowDiff == 0 || colDiff == 0) {
-        int direction = (move.to > move.from) ? 1 : -1;
-        int step = (colDiff == 0) ? 8 * direction : 1 * direction;
-
-        for (int i = move.from + step; i != move.to; i += step) {
-            if (occupied & (1ULL << i)) {
-                return false;
-            }
-        }
-
-        if (!(toBit & ownPieces)) {
-            return true;
-        }
-    }
+bool MoveValidator::isValidRookMove(PackedMove move, int player, uint64_t rooks, uint64_t ownPieces, uint64_t occupied) {
+    uint64_t toBit = 1ULL << move.to();
 
-    return false;
+    return (Attacks::rookAttacks(move.from(), occupied) & toBit) && !(toBit & ownPieces);
 }
 
-bool MoveValidator::isValidQueenMove(const Move& move, int player, uint64_t queens, uint64_t ownPieces, uint64_t occupied) {
+bool MoveValidator::isValidQueenMove(PackedMove move, int player, uint64_t queens, uint64_t ownPieces, uint64_t occupied) {
     return isValidBishopMove(move, player, queens, ownPieces, occupied) || isValidRookMove(move, player, queens, ownPieces, occupied);
 }
 
-bool MoveValidator::isValidKingMove(const Move& move, int player, uint64_t king, uint64_t ownPieces) {
-    uint64_t fromBit = 1ULL << move.from;
-    uint64_t toBit = 1ULL << move.to;
+bool MoveValidator::isValidKingMove(PackedMove move, int player, uint64_t king, uint64_t ownPieces) {
+    uint64_t toBit = 1ULL << move.to();
 
-    int rowDiff = abs((move.from / 8) - (move.to / 8));
-    int colDiff = abs((move.from % 8) - (move.to % 8));
-
-    if ((rowDiff <= 1 && colDiff <= 1) && !(toBit & ownPieces)) {
-        return true;
-    }
-
-    return false;
+    return (Attacks::kingAttacks(move.from()) & toBit) && !(toBit & ownPieces);
 }
 
 bool MoveValidator::canCastleKingside(int player, const ChessEngine& engine) {
+    uint64_t occupied = engine.occupancy[ALL];
+    uint64_t opponentPieces = engine.occupancy[1 - player];
     if (player == 0) {
         return !engine.getWhiteKingMoved() && !engine.getWhiteRookH1Moved() &&
-               !(engine.whitePawns & 0x0000000000000060) && // ensure no pieces on F1 and G1
-               !(engine.whiteKnights & 0x0000000000000060) &&
-               !(engine.whiteBishops & 0x0000000000000060) &&
-               !(engine.whiteRooks & 0x0000000000000060) &&
-               !(engine.whiteQueens & 0x0000000000000060) &&
-               !(engine.whiteKing & 0x0000000000000060);
+               (engine.bitboards[0][KING] & (1ULL << 4)) && (engine.bitboards[0][ROOK] & (1ULL << 7)) &&
+               !(occupied & 0x0000000000000060) && // ensure no pieces on F1 and G1
+               !(attackersTo(engine, 4, occupied) & opponentPieces) && // E1, F1 and G1 must not be attacked
+               !(attackersTo(engine, 5, occupied) & opponentPieces) &&
+               !(attackersTo(engine, 6, occupied) & opponentPieces);
     } else {
         return !engine.getBlackKingMoved() && !engine.getBlackRookH8Moved() &&
-               !(engine.blackPawns & 0x6000000000000000) && // ensure no pieces on F8 and G8
-               !(engine.blackKnights & 0x6000000000000000) &&
-               !(engine.blackBishops & 0x6000000000000000) &&
-               !(engine.blackRooks & 0x6000000000000000) &&
-               !(engine.blackQueens & 0x6000000000000000) &&
-               !(engine.blackKing & 0x6000000000000000);
+               (engine.bitboards[1][KING] & (1ULL << 60)) && (engine.bitboards[1][ROOK] & (1ULL << 63)) &&
+               !(occupied & 0x6000000000000000) && // ensure no pieces on F8 and G8
+               !(attackersTo(engine, 60, occupied) & opponentPieces) && // E8, F8 and G8 must not be attacked
+               !(attackersTo(engine, 61, occupied) & opponentPieces) &&
+               !(attackersTo(engine, 62, occupied) & opponentPieces);
     }
 }
 
 bool MoveValidator::canCastleQueenside(int player, const ChessEngine& engine) {
+    uint64_t occupied = engine.occupancy[ALL];
+    uint64_t opponentPieces = engine.occupancy[1 - player];
     if (player == 0) {
         return !engine.getWhiteKingMoved() && !engine.getWhiteRookA1Moved() &&
-               !(engine.whitePawns & 0x000000000000000E) && // ensure no pieces on B1, C1, D1
-               !(engine.whiteKnights & 0x000000000000000E) &&
-               !(engine.whiteBishops & 0x000000000000000E) &&
-               !(engine.whiteRooks & 0x000000000000000E) &&
-               !(engine.whiteQueens & 0x000000000000000E) &&
-               !(engine.whiteKing & 0x000000000000000E);
+               (engine.bitboards[0][KING] & (1ULL << 4)) && (engine.bitboards[0][ROOK] & 1ULL) &&
+               !(occupied & 0x000000000000000E) && // ensure no pieces on B1, C1, D1
+               !(attackersTo(engine, 4, occupied) & opponentPieces) && // E1, D1 and C1 must not be attacked
+               !(attackersTo(engine, 3, occupied) & opponentPieces) &&
+               !(attackersTo(engine, 2, occupied) & opponentPieces);
     } else {
         return !engine.getBlackKingMoved() && !engine.getBlackRookA8Moved() &&
-               !(engine.blackPawns & 0x0E00000000000000) && // ensure no pieces on B8, C8, D8
-               !(engine.blackKnights & 0x0E00000000000000) &&
-               !(engine.blackBishops & 0x0E00000000000000) &&
-               !(engine.blackRooks & 0x0E00000000000000) &&
-               !(engine.blackQueens & 0x0E00000000000000) &&
-               !(engine.blackKing & 0x0E00000000000000);
+               (engine.bitboards[1][KING] & (1ULL << 60)) && (engine.bitboards[1][ROOK] & (1ULL << 56)) &&
+               !(occupied & 0x0E00000000000000) && // ensure no pieces on B8, C8, D8
+               !(attackersTo(engine, 60, occupied) & opponentPieces) && // E8, D8 and C8 must not be attacked
+               !(attackersTo(engine, 59, occupied) & opponentPieces) &&
+               !(attackersTo(engine, 58, occupied) & opponentPieces);
     }
 }
 
-bool MoveValidator::doesMoveExposeKing(const Move& move, int player, const ChessEngine& engine) {
-    ChessEngine testEngine = engine;
-    MoveExecutor::makeMove(testEngine, move, player);
+bool MoveValidator::doesMoveExposeKing(PackedMove move, int player, const ChessEngine& engine) {
+    uint64_t fromBit = 1ULL << move.from();
+    uint64_t toBit = 1ULL << move.to();
 
-    // find the king's position
-    uint64_t kingPosition = player == 0 ? testEngine.whiteKing : testEngine.blackKing;
-    int kingSquare = __builtin_ffsll(kingPosition) - 1;
+    uint64_t pawns = engine.bitboards[player][PAWN];
+    uint64_t king = engine.bitboards[player][KING];
+    uint64_t opponentPieces = engine.occupancy[1 - player];
+    uint64_t occupied = engine.occupancy[ALL];
 
-    // generate all opponent moves
-    std::vector<Move> opponentMoves = testEngine.generateAllPossibleMoves(1 - player);
-    for (const Move& opponentMove : opponentMoves) {
-        if (opponentMove.to == kingSquare) {
-            return true;
-        }
+    // work out the occupancy after the move instead of playing it on a copy of the engine
+    uint64_t captured = toBit & opponentPieces;
+    if ((pawns & fromBit) && move.to() == engine.getEnPassantTarget()) {
+        captured = 1ULL << (player == 0 ? move.to() - 8 : move.to() + 8);
     }
-    return false;
+    uint64_t occupiedAfter = (occupied ^ fromBit ^ captured) | toBit;
+    int kingSquare = (king & fromBit) ? move.to() : __builtin_ctzll(king);
+
+    // a captured piece no longer attacks anything
+    return (attackersTo(engine, kingSquare, occupiedAfter) & opponentPieces & ~captured) != 0;
 }
 
 bool MoveValidator::isSquareAttacked(const ChessEngine& engine, int square, int attacker) {
-    uint64_t attackMask = 0;
+    uint64_t occupied = engine.occupancy[ALL];
+    uint64_t attackerPieces = engine.occupancy[attacker];
 
-    // generate attack mask for the opponent
-    std::vector<Move> opponentMoves = MoveGenerator::generateAllMoves(engine, attacker);
-    for (const Move& move : opponentMoves) {
-        attackMask |= (1ULL << move.to);
-    }
+    return (attackersTo(engine, square, occupied) & attackerPieces) != 0;
+}
 
-    return attackMask & (1ULL << square);
-}
\ No newline at end of file
+uint64_t MoveValidator::attackersTo(const ChessEngine& engine, int square, uint64_t occupied) {
+    // every attack relation is symmetric, so look outward from the square itself
+    // (a white pawn hits the square iff a black pawn on the square would hit the white pawn)
+    const uint64_t* white = engine.bitboards[0];
+    const uint64_t* black = engine.bitboards[1];
+    return (Attacks::pawnAttacks(1, square) & white[PAWN]) |
+           (Attacks::pawnAttacks(0, square) & black[PAWN]) |
+           (Attacks::knightAttacks(square) & (white[KNIGHT] | black[KNIGHT])) |
+           (Attacks::kingAttacks(square) & (white[KING] | black[KING])) |
+           (Attacks::bishopAttacks(square, occupied) & (white[BISHOP] | black[BISHOP] | white[QUEEN] | black[QUEEN])) |
+           (Attacks::rookAttacks(square, occupied) & (white[ROOK] | black[ROOK] | white[QUEEN] | black[QUEEN]));
+}
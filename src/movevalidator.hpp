@@ -19,6 +19,15 @@ public:
      */
     static bool isValidMove(const Move& move, int player, const ChessEngine& engine);
 
+    /**
+     * @brief Checks if a move is valid for the given player.
+     * @param move The move to validate.
+     * @param player The player making the move (0 for white, 1 for black).
+     * @param engine The chess engine containing the game state.
+     * @return True if the move is valid, false otherwise.
+     */
+    static bool isValidMove(PackedMove move, int player, const ChessEngine& engine);
+
     /**
      * @brief Checks if a pawn move is valid for the given player.
      * @param move The pawn move to validate.
@@ -28,7 +37,7 @@ public:
      * @param enPassantTarget The en passant target square.
      * @return True if the pawn move is valid, false otherwise.
      */
-    static bool isValidPawnMove(const Move& move, int player, uint64_t pawns, uint64_t opponentPieces, int enPassantTarget);
+    static bool isValidPawnMove(PackedMove move, int player, uint64_t pawns, uint64_t opponentPieces, int enPassantTarget);
 
     /**
      * @brief Checks if a knight move is valid for the given player.
@@ -38,7 +47,7 @@ public:
      * @param ownPieces The bitboard representing the player's own pieces.
      * @return True if the knight move is valid, false otherwise.
      */
-    static bool isValidKnightMove(const Move& move, int player, uint64_t knights, uint64_t ownPieces);
+    static bool isValidKnightMove(PackedMove move, int player, uint64_t knights, uint64_t ownPieces);
 
     /**
      * @brief Checks if a bishop move is valid for the given player.
@@ -49,7 +58,7 @@ public:
      * @param occupied The bitboard representing all occupied squares.
      * @return True if the bishop move is valid, false otherwise.
      */
-    static bool isValidBishopMove(const Move& move, int player, uint64_t bishops, uint64_t ownPieces, uint64_t occupied);
+    static bool isValidBishopMove(PackedMove move, int player, uint64_t bishops, uint64_t ownPieces, uint64_t occupied);
 
     /**
      * @brief Checks if a rook move is valid for the given player.
@@ -60,7 +69,7 @@ public:
      * @param occupied The bitboard representing all occupied squares.
      * @return True if the rook move is valid, false otherwise.
      */
-    static bool isValidRookMove(const Move& move, int player, uint64_t rooks, uint64_t ownPieces, uint64_t occupied);
+    static bool isValidRookMove(PackedMove move, int player, uint64_t rooks, uint64_t ownPieces, uint64_t occupied);
 
     /**
      * @brief Checks if a queen move is valid for the given player.
@@ -71,7 +80,7 @@ public:
      * @param occupied The bitboard representing all occupied squares.
      * @return True if the queen move is valid, false otherwise.
      */
-    static bool isValidQueenMove(const Move& move, int player, uint64_t queens, uint64_t ownPieces, uint64_t occupied);
+    static bool isValidQueenMove(PackedMove move, int player, uint64_t queens, uint64_t ownPieces, uint64_t occupied);
 
     /**
      * @brief Checks if a king move is valid for the given player.
@@ -81,10 +90,10 @@ public:
      * @param ownPieces The bitboard representing the player's own pieces.
      * @return True if the king move is valid, false otherwise.
      */
-    static bool isValidKingMove(const Move& move, int player, uint64_t king, uint64_t ownPieces);
+    static bool isValidKingMove(PackedMove move, int player, uint64_t king, uint64_t ownPieces);
 
     /**
-     * @brief Checks if the player can castle kingside.
+     * @brief Checks if the player can castle kingside: castling rights, empty path, and the king is neither in check nor passes through or lands on an attacked square.
      * @param player The player to check for (0 for white, 1 for black).
      * @param engine The chess engine containing the game state.
      * @return True if the player can castle kingside, false otherwise.
@@ -92,7 +101,7 @@ public:
     static bool canCastleKingside(int player, const ChessEngine& engine);
 
     /**
-     * @brief Checks if the player can castle queenside.
+     * @brief Checks if the player can castle queenside: castling rights, empty path, and the king is neither in check nor passes through or lands on an attacked square.
      * @param player The player to check for (0 for white, 1 for black).
      * @param engine The chess engine containing the game state.
      * @return True if the player can castle queenside, false otherwise.
@@ -106,7 +115,7 @@ public:
      * @param engine The chess engine containing the game state.
      * @return True if the move exposes the king to check, false otherwise.
      */
-    static bool doesMoveExposeKing(const Move& move, int player, const ChessEngine& engine);
+    static bool doesMoveExposeKing(PackedMove move, int player, const ChessEngine& engine);
 
     /**
      * @brief Checks if a square is attacked by the specified player.
@@ -116,6 +125,15 @@ public:
      * @return True if the square is attacked, false otherwise.
      */
     static bool isSquareAttacked(const ChessEngine& engine, int square, int attacker);
+
+    /**
+     * @brief Finds all pieces of either color attacking a square, by looking up the reverse attacks from the square.
+     * @param engine The chess engine containing the game state.
+     * @param square The square to check.
+     * @param occupied The occupancy used to block sliders. Usually the board, but may describe a hypothetical position.
+     * @return The bitboard of attacking pieces. Intersect with a player's pieces to get that player's attackers.
+     */
+    static uint64_t attackersTo(const ChessEngine& engine, int square, uint64_t occupied);
 };
 
 #endif // MOVEVALIDATOR_HPP
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "perft.hpp"
+#include "movegenerator.hpp"
+#include "moveexecutor.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+const PerftPosition Perft::referencePositions[] = {
+    {"start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603},
+    {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083},
+    {"position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292},
+    {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487},
+    {"position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594}
+};
+
+const int Perft::referencePositionCount = sizeof(referencePositions) / sizeof(referencePositions[0]);
+
+PerftHashTable::PerftHashTable(size_t megabytes) {
+    size_t count = 1;
+    while (count * 2 * sizeof(Entry) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+    entries = std::vector<Entry>(count);
+    mask = count - 1;
+}
+
+bool PerftHashTable::probe(uint64_t hash, int player, int depth, uint64_t& nodes) const {
+    const Entry& entry = entries[hash & mask];
+    uint64_t data = entry.data.load(std::memory_order_relaxed);
+    uint64_t key = entry.key.load(std::memory_order_relaxed);
+
+    // a torn or foreign entry fails the key check, and the low byte pins the side to move and depth
+    if ((key ^ data) != hash || (data & 0xFF) != pack(player, depth, 0)) {
+        return false;
+    }
+    nodes = data >> 8;
+    return true;
+}
+
+void PerftHashTable::store(uint64_t hash, int player, int depth, uint64_t nodes) {
+    Entry& entry = entries[hash & mask];
+    uint64_t data = pack(player, depth, nodes);
+    entry.key.store(hash ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
+
+uint64_t Perft::count(const ChessEngine& engine, int player, int depth) {
+    ChessEngine position = engine;
+    return countInPlace(position, player, depth);
+}
+
+uint64_t Perft::countInPlace(ChessEngine& engine, int player, int depth) {
+    if (depth <= 0) {
+        return 1;
+    }
+
+    MoveList moves;
+    MoveGenerator::generateAllValidMoves(engine, player, moves);
+
+    // bulk counting: every legal move at the last ply is a leaf
+    if (depth == 1) {
+        return moves.size();
+    }
+
+    uint64_t nodes = 0;
+    for (PackedMove move : moves) {
+        UndoRecord undo;
+        MoveExecutor::makeMove(engine, move, player, undo);
+        nodes += countInPlace(engine, 1 - player, depth - 1);
+        MoveExecutor::unmakeMove(engine, undo, player);
+    }
+    return nodes;
+}
+
+uint64_t Perft::divide(const ChessEngine& engine, int player, int depth, std::ostream& out) {
+    auto start = std::chrono::steady_clock::now();
+
+    MoveList moves;
+    MoveGenerator::generateAllValidMoves(engine, player, moves);
+
+    ChessEngine position = engine;
+    uint64_t total = 0;
+    for (PackedMove move : moves) {
+        UndoRecord undo;
+        MoveExecutor::makeMove(position, move, player, undo);
+        uint64_t nodes = countInPlace(position, 1 - player, depth - 1);
+        MoveExecutor::unmakeMove(position, undo, player);
+        out << Utils::moveToUCI(move) << ": " << nodes << '\n';
+        total += nodes;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    out << '\n' << "Nodes searched: " << total << '\n';
+    out << "Time: " << elapsed / 1000 << " ms" << '\n';
+    out << "Nodes/second: " << (elapsed > 0 ? total * 1000000 / elapsed : 0) << std::endl;
+    return total;
+}
+
+uint64_t Perft::countHashed(ChessEngine& engine, int player, int depth, PerftHashTable& table) {
+    // the bottom two plies are cheaper to count than to hash
+    if (depth <= 2) {
+        return countInPlace(engine, player, depth);
+    }
+
+    uint64_t hash = engine.getHash();
+    uint64_t nodes = 0;
+    if (table.probe(hash, player, depth, nodes)) {
+        return nodes;
+    }
+
+    MoveList moves;
+    MoveGenerator::generateAllValidMoves(engine, player, moves);
+    for (PackedMove move : moves) {
+        UndoRecord undo;
+        MoveExecutor::makeMove(engine, move, player, undo);
+        nodes += countHashed(engine, 1 - player, depth - 1, table);
+        MoveExecutor::unmakeMove(engine, undo, player);
+    }
+
+    table.store(hash, player, depth, nodes);
+    return nodes;
+}
+
+PerftResult Perft::parallelCount(const ChessEngine& engine, int player, int depth, int threads, size_t hashMegabytes) {
+    // a unit of work: the subtree below one position, credited to the root move it descends from
+    struct Task {
+        int rootMove;
+        ChessEngine position;
+        int player;
+        int depth;
+        uint64_t nodes;
+    };
+
+    PerftResult result;
+    result.nodes = 0;
+    threads = std::max(threads, 1);
+    result.threadNodes.assign(threads, 0);
+
+    MoveList rootMoves;
+    MoveGenerator::generateAllValidMoves(engine, player, rootMoves);
+    result.moveNodes.assign(rootMoves.size(), 0);
+    if (depth <= 0) {
+        result.nodes = 1;
+        return result;
+    }
+
+    // split two plies deep so there are enough tasks to keep every thread busy
+    std::vector<Task> tasks;
+    for (int i = 0; i < rootMoves.size(); ++i) {
+        ChessEngine child = engine;
+        MoveExecutor::makeMove(child, rootMoves[i], player);
+        if (depth < 3) {
+            tasks.push_back({i, child, 1 - player, depth - 1, 0});
+            continue;
+        }
+
+        MoveList replies;
+        MoveGenerator::generateAllValidMoves(child, 1 - player, replies);
+        for (PackedMove reply : replies) {
+            ChessEngine grandchild = child;
+            MoveExecutor::makeMove(grandchild, reply, 1 - player);
+            tasks.push_back({i, grandchild, player, depth - 2, 0});
+        }
+    }
+
+    PerftHashTable table(hashMegabytes);
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            uint64_t nodes = 0;
+            for (size_t i = next++; i < tasks.size(); i = next++) {
+                Task& task = tasks[i];
+                task.nodes = countHashed(task.position, task.player, task.depth, table);
+                nodes += task.nodes;
+            }
+            result.threadNodes[t] = nodes;
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (const Task& task : tasks) {
+        result.moveNodes[task.rootMove] += task.nodes;
+        result.nodes += task.nodes;
+    }
+    return result;
+}
+
+uint64_t Perft::parallelDivide(const ChessEngine& engine, int player, int depth, int threads, std::ostream& out) {
+    auto start = std::chrono::steady_clock::now();
+
+    PerftResult result = parallelCount(engine, player, depth, threads);
+
+    MoveList moves;
+    MoveGenerator::generateAllValidMoves(engine, player, moves);
+    for (int i = 0; i < moves.size(); ++i) {
+        out << Utils::moveToUCI(moves[i]) << ": " << result.moveNodes[i] << '\n';
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    out << '\n';
+    for (size_t t = 0; t < result.threadNodes.size(); ++t) {
+        out << "Thread " << t << ": " << result.threadNodes[t] << " nodes" << '\n';
+    }
+    out << "Nodes searched: " << result.nodes << '\n';
+    out << "Time: " << elapsed / 1000 << " ms" << '\n';
+    out << "Nodes/second: " << (elapsed > 0 ? result.nodes * 1000000 / elapsed : 0) << std::endl;
+    return result.nodes;
+}
+
+bool Perft::runReferenceSuite(std::ostream& out, int threads) {
+    bool allPassed = true;
+
+    for (int i = 0; i < referencePositionCount; ++i) {
+        const PerftPosition& position = referencePositions[i];
+        ChessEngine engine;
+        int player = engine.loadFEN(position.fen);
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = threads > 1 ? parallelCount(engine, player, position.depth, threads).nodes
+                                     : count(engine, player, position.depth);
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        bool passed = nodes == position.nodes;
+        allPassed = allPassed && passed;
+        out << (passed ? "OK    " : "FAIL  ") << position.name << " depth " << position.depth << ": " << nodes;
+        if (!passed) {
+            out << " (expected " << position.nodes << ")";
+        }
+        out << ", " << elapsed / 1000 << " ms, " << (elapsed > 0 ? nodes * 1000000 / elapsed : 0) << " nodes/second" << std::endl;
+    }
+
+    return allPassed;
+}
@@ -0,0 +1,164 @@
+#ifndef PERFT_HPP
+#define PERFT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "chessengine.hpp"
+
+/**
+ * @brief A position with a known perft node count, used as a correctness reference for move generation.
+ */
+struct PerftPosition {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+
+/**
+ * @brief Outcome of a parallel perft run.
+ */
+struct PerftResult {
+    uint64_t nodes;                    // total leaf nodes
+    std::vector<uint64_t> moveNodes;   // leaf nodes below each root move, in generation order
+    std::vector<uint64_t> threadNodes; // leaf nodes counted by each worker thread
+};
+
+/**
+ * @class PerftHashTable
+ * @brief Lock-free cache of subtree node counts shared by the perft worker threads, keyed by Zobrist hash, side to
+ * move and depth. Each entry stores the key XORed with the data, so a write torn by a concurrent store fails the key
+ * check on probe instead of returning a wrong count.
+ */
+class PerftHashTable {
+public:
+    /**
+     * @brief Allocates the table, rounded down to a power of two entries.
+     * @param megabytes The table size in megabytes.
+     */
+    explicit PerftHashTable(size_t megabytes);
+
+    /**
+     * @brief Looks up the node count of a subtree.
+     * @param hash The Zobrist hash of the position.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The remaining depth.
+     * @param nodes Receives the node count on a hit.
+     * @return true If the subtree was found.
+     * @return false Otherwise.
+     */
+    bool probe(uint64_t hash, int player, int depth, uint64_t& nodes) const;
+
+    /**
+     * @brief Stores the node count of a subtree, replacing whatever occupied the slot.
+     * @param hash The Zobrist hash of the position.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The remaining depth.
+     * @param nodes The node count.
+     */
+    void store(uint64_t hash, int player, int depth, uint64_t nodes);
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> key;  // hash XOR data
+        std::atomic<uint64_t> data; // node count in the upper 56 bits, side to move in bit 7, depth in bits 0-6
+    };
+
+    static uint64_t pack(int player, int depth, uint64_t nodes) {
+        return nodes << 8 | static_cast<uint64_t>(player) << 7 | static_cast<uint64_t>(depth);
+    }
+
+    std::vector<Entry> entries;
+    size_t mask;
+};
+
+/**
+ * @class Perft
+ * @brief Counts the leaf nodes of the legal move tree (performance test). Serves both as a move generation
+ * throughput benchmark and, through the reference positions, as a correctness gate.
+ */
+class Perft {
+public:
+    /**
+     * @brief Counts the leaf nodes below a position. The last ply is bulk counted from the size of the move list.
+     * @param engine The chess engine containing the game state.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The number of plies to search.
+     * @return The number of leaf nodes.
+     */
+    static uint64_t count(const ChessEngine& engine, int player, int depth);
+
+    /**
+     * @brief Counts the leaf nodes below each root move and prints the breakdown, the total and the speed.
+     * @param engine The chess engine containing the game state.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The number of plies to search.
+     * @param out The stream the breakdown is written to.
+     * @return The total number of leaf nodes.
+     */
+    static uint64_t divide(const ChessEngine& engine, int player, int depth, std::ostream& out);
+
+    /**
+     * @brief Counts the leaf nodes below a position on several threads. The tree is split into the subtrees below
+     * every reply to every root move, which the workers pull from a shared queue, and repeated subtrees are served
+     * from a shared hash table.
+     * @param engine The chess engine containing the game state.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The number of plies to search.
+     * @param threads The number of worker threads.
+     * @param hashMegabytes The size of the shared subtree cache in megabytes.
+     * @return The total, per root move and per thread node counts.
+     */
+    static PerftResult parallelCount(const ChessEngine& engine, int player, int depth, int threads, size_t hashMegabytes = 64);
+
+    /**
+     * @brief Parallel version of divide. Also prints the nodes counted by each thread.
+     * @param engine The chess engine containing the game state.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The number of plies to search.
+     * @param threads The number of worker threads.
+     * @param out The stream the breakdown is written to.
+     * @return The total number of leaf nodes.
+     */
+    static uint64_t parallelDivide(const ChessEngine& engine, int player, int depth, int threads, std::ostream& out);
+
+    /**
+     * @brief Runs every reference position and compares the node counts against the known values.
+     * @param out The stream the results are written to.
+     * @param threads The number of worker threads, 1 runs the plain single threaded count.
+     * @return true If every count matches.
+     * @return false Otherwise.
+     */
+    static bool runReferenceSuite(std::ostream& out, int threads = 1);
+
+    /**
+     * @brief The standard reference positions (start position, Kiwipete and positions 3-6 from the Chess Programming Wiki).
+     */
+    static const PerftPosition referencePositions[];
+    static const int referencePositionCount;
+
+private:
+    /**
+     * @brief Counts the leaf nodes below a position, making and unmaking moves on the given engine.
+     * @param engine The chess engine containing the game state, restored before returning.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The number of plies to search.
+     * @return The number of leaf nodes.
+     */
+    static uint64_t countInPlace(ChessEngine& engine, int player, int depth);
+
+    /**
+     * @brief Counts the leaf nodes below a position, reusing and filling the shared subtree cache.
+     * @param engine The chess engine containing the game state, restored before returning.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The number of plies to search.
+     * @param table The shared subtree cache.
+     * @return The number of leaf nodes.
+     */
+    static uint64_t countHashed(ChessEngine& engine, int player, int depth, PerftHashTable& table);
+};
+
+#endif // PERFT_HPP
@@ -0,0 +1,601 @@
+#include "search.hpp"
+#include "evaluation.hpp"
+#include "movegenerator.hpp"
+#include "moveexecutor.hpp"
+#include "movepicker.hpp"
+#include "movevalidator.hpp"
+#include "perft.hpp"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <utility>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+const int Search::infinity;
+const int Search::pieceValues[6] = {100, 300, 300, 500, 900, 0};
+const int Search::futilityMargins[3] = {0, 200, 500};
+
+const int Search::skipSize[skipPatterns] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+const int Search::skipPhase[skipPatterns] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+SearchResult Search::search(const ChessEngine& engine, int player, int depth) {
+    TranspositionTable table(16);
+    return search(engine, player, depth, table);
+}
+
+SearchResult Search::search(const ChessEngine& engine, int player, int depth, TranspositionTable& table) {
+    return search(engine, player, depth, table, 1);
+}
+
+SearchResult Search::search(const ChessEngine& engine, int player, int depth, TranspositionTable& table, int threads, bool pinThreads) {
+    SearchLimits limits;
+    limits.depth = depth;
+    return search(engine, player, limits, table, threads, pinThreads);
+}
+
+SearchResult Search::search(const ChessEngine& engine, int player, const SearchLimits& limits, TranspositionTable& table, int threads,
+                            bool pinThreads, const SearchOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    table.newSearch();
+    int depth = limits.depth > 0 ? std::min(limits.depth, maxPly - 1) : maxPly - 1;
+
+    std::vector<Context> contexts(std::max(1, threads));
+    Shared shared;
+    shared.stop.store(false, std::memory_order_relaxed);
+    shared.limits = &limits;
+    shared.options = &options;
+    shared.contexts = &contexts;
+    setDeadlines(limits, player, start, shared);
+
+    for (size_t i = 0; i < contexts.size(); ++i) {
+        contexts[i].nodes = 0;
+        contexts[i].publishedNodes.store(0, std::memory_order_relaxed);
+        contexts[i].completedIteration = false;
+        contexts[i].table = &table;
+        contexts[i].threadIndex = static_cast<int>(i);
+        contexts[i].shared = &shared;
+        contexts[i].verifying = false;
+        resetOrdering(contexts[i]);
+    }
+
+    // the helpers keep deepening until the calling thread is done, their results only reach it through the table
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < contexts.size(); ++i) {
+        helpers.emplace_back([&engine, player, pinThreads, &contexts, i]() {
+            if (pinThreads) {
+                pinToCore(static_cast<int>(i));
+            }
+            iterate(engine, player, maxPly - 1, contexts[i]);
+        });
+    }
+
+    SearchResult result = iterate(engine, player, depth, contexts[0]);
+
+    shared.stop.store(true, std::memory_order_relaxed);
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    result.nodes = 0;
+    for (const Context& context : contexts) {
+        result.nodes += context.nodes;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void Search::runBenchmark(std::ostream& out, int depth, int threads, size_t hashMegabytes, bool pinThreads) {
+    TranspositionTable table(hashMegabytes, true);
+
+    double baseline = 0;
+    for (int count = 1; ; count = std::min(count * 2, threads)) {
+        double seconds = 0;
+        uint64_t nodes = 0;
+        for (int i = 0; i < Perft::referencePositionCount; ++i) {
+            ChessEngine engine;
+            engine.setHeadless(true);
+            int player = engine.loadFEN(Perft::referencePositions[i].fen);
+
+            table.clear();
+            SearchResult result = search(engine, player, depth, table, count, pinThreads);
+            seconds += result.seconds;
+            nodes += result.nodes;
+        }
+        if (count == 1) {
+            baseline = seconds;
+        }
+
+        out << "threads " << count << ": " << seconds << " s to depth " << depth << ", " << nodes << " nodes, "
+            << static_cast<uint64_t>(nodes / std::max(seconds, 1e-9)) << " nodes/s, speedup " << baseline / std::max(seconds, 1e-9) << std::endl;
+
+        if (count == threads) {
+            break;
+        }
+    }
+}
+
+void Search::runPruningBenchmark(std::ostream& out, int depth, size_t hashMegabytes) {
+    TranspositionTable table(hashMegabytes, true);
+
+    // the full-width search comes first, as the reference for the others
+    std::vector<std::pair<std::string, SearchOptions>> configurations(6);
+    configurations[0].first = "full width";
+    configurations[0].second.nullMovePruning = configurations[0].second.lateMoveReductions = false;
+    configurations[0].second.reverseFutilityPruning = configurations[0].second.futilityPruning = false;
+    configurations[1].first = "all techniques";
+    configurations[2].first = "no null-move pruning";
+    configurations[2].second.nullMovePruning = false;
+    configurations[3].first = "no late-move reductions";
+    configurations[3].second.lateMoveReductions = false;
+    configurations[4].first = "no reverse futility pruning";
+    configurations[4].second.reverseFutilityPruning = false;
+    configurations[5].first = "no futility pruning";
+    configurations[5].second.futilityPruning = false;
+
+    SearchLimits limits;
+    limits.depth = depth;
+    uint64_t baseline = 0;
+    for (const auto& configuration : configurations) {
+        double seconds = 0;
+        uint64_t nodes = 0;
+        for (int i = 0; i < Perft::referencePositionCount; ++i) {
+            ChessEngine engine;
+            engine.setHeadless(true);
+            int player = engine.loadFEN(Perft::referencePositions[i].fen);
+
+            table.clear();
+            SearchResult result = search(engine, player, limits, table, 1, false, configuration.second);
+            seconds += result.seconds;
+            nodes += result.nodes;
+        }
+        if (baseline == 0) {
+            baseline = nodes;
+        }
+
+        out << configuration.first << ": " << seconds << " s to depth " << depth << ", " << nodes << " nodes, "
+            << 100.0 * nodes / std::max<uint64_t>(baseline, 1) << "% of full width" << std::endl;
+    }
+}
+
+SearchResult Search::iterate(const ChessEngine& engine, int player, int depth, Context& context) {
+    ChessEngine position = engine;
+
+    SearchResult result;
+    result.score = 0;
+    result.depth = 0;
+
+    for (int iteration = 1; iteration <= depth; ++iteration) {
+        if (skipsIteration(context.threadIndex, iteration)) {
+            continue;
+        }
+
+        // an iteration started after the soft deadline would most likely be abandoned at the hard one
+        if (context.completedIteration && context.shared->timed && std::chrono::steady_clock::now() >= context.shared->softDeadline) {
+            break;
+        }
+
+        // aspiration window: the score is expected close to the last one, and a narrow window cuts more; a score on
+        // the edge of the window only bounds the true score, so that side is widened and the iteration searched again
+        int alpha = -infinity;
+        int beta = infinity;
+        int delta = aspirationWindow;
+        if (result.depth >= aspirationDepth && !isMateScore(result.score)) {
+            alpha = std::max(result.score - delta, -infinity);
+            beta = std::min(result.score + delta, infinity);
+        }
+
+        int score;
+        while (true) {
+            context.played[0] = PackedMove();
+            score = negamax<true>(position, player, iteration, 0, alpha, beta, context);
+            if (context.shared->stop.load(std::memory_order_relaxed)) {
+                break;
+            }
+            if (score <= alpha && alpha > -infinity) {
+                delta *= 2;
+                alpha = delta > maxAspirationWindow ? -infinity : std::max(score - delta, -infinity);
+            } else if (score >= beta && beta < infinity) {
+                delta *= 2;
+                beta = delta > maxAspirationWindow ? infinity : std::min(score + delta, infinity);
+            } else {
+                break;
+            }
+        }
+        if (context.shared->stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+        context.completedIteration = true;
+
+        int length = context.pvLength[0];
+        result.score = score;
+        result.depth = iteration;
+        result.pv.assign(context.pvTable[0], context.pvTable[0] + length);
+        result.bestMove = length > 0 ? context.pvTable[0][0] : PackedMove();
+
+        // no legal move at the root, or a forced mate that a deeper search cannot improve on
+        if (length == 0 || mateScore - std::abs(score) <= iteration) {
+            break;
+        }
+    }
+    return result;
+}
+
+bool Search::isMateScore(int score) {
+    return std::abs(score) >= mateScore - maxPly;
+}
+
+std::string Search::scoreToString(int score) {
+    if (!isMateScore(score)) {
+        return "cp " + std::to_string(score);
+    }
+    // plies to mate, rounded up to moves of the mating side
+    int plies = mateScore - std::abs(score);
+    int moves = (plies + 1) / 2;
+    return "mate " + std::to_string(score > 0 ? moves : -moves);
+}
+
+template <bool pvNode>
+int Search::negamax(ChessEngine& engine, int player, int depth, int ply, int alpha, int beta, Context& context) {
+    if (pvNode) {
+        context.pvLength[ply] = ply;
+    }
+    if (context.shared->stop.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    context.path[ply] = engine.hash;
+
+    // draws by repetition or the fifty-move rule, never at the root where a move has to be returned; as in
+    // Utils::getGameStatus, checkmate takes precedence over the fifty-move rule, and is scored below
+    if (ply > 0 && (isRepetition(engine, context, ply) ||
+                    (engine.halfMoveClock >= 100 && (!isInCheck(engine, player) || MoveGenerator::hasAnyLegalMove(engine, player))))) {
+        return 0;
+    }
+
+    if (depth <= 0 || ply >= maxPly - 1) {
+        return quiescence(engine, player, ply, alpha, beta, context);
+    }
+    countNode(context);
+
+    // a stored result at least as deep settles a null-window node if its bound allows, otherwise its move is tried
+    // first; principal variation nodes are always searched, so that their line is complete
+    TableEntry entry;
+    PackedMove hashMove = PackedMove();
+    if (context.table->probe(engine.hash, entry)) {
+        hashMove = entry.move;
+        int score = scoreFromTable(entry.score, ply);
+        if (!pvNode && entry.depth >= depth &&
+            (entry.bound == Bound::EXACT ||
+             (entry.bound == Bound::LOWER && score >= beta) ||
+             (entry.bound == Bound::UPPER && score <= alpha))) {
+            return score;
+        }
+    }
+
+    const SearchOptions& options = *context.shared->options;
+    bool inCheck = isInCheck(engine, player);
+
+    // the selective techniques trust the static evaluation, which means nothing in check, and never prune the root;
+    // the node-level cutoffs only apply to null-window nodes, where failing high is all that is asked
+    int staticEval = 0;
+    bool selective = ply > 0 && !inCheck;
+    if (selective) {
+        staticEval = evaluate(engine, player);
+    }
+
+    // reverse futility pruning: so far above beta that no quiet continuation is expected to bring it back down
+    if (!pvNode && selective && options.reverseFutilityPruning && depth <= reverseFutilityDepth && !isMateScore(beta) &&
+        staticEval - reverseFutilityMargin * depth >= beta) {
+        return beta;
+    }
+
+    // null-move pruning: if passing still fails high, a real move will too, except in zugzwang, which is guarded
+    // against by never passing without pieces, never twice in a row, and verifying deep cutoffs with a normal search
+    if (!pvNode && selective && options.nullMovePruning && depth >= nullMoveDepth && staticEval >= beta && !isMateScore(beta) &&
+        !context.verifying && context.played[ply] != PackedMove() && hasNonPawnMaterial(engine, player)) {
+        int reduction = 3 + depth / 6;
+        UndoRecord undo;
+        MoveExecutor::makeNullMove(engine, player, undo);
+        context.played[ply + 1] = PackedMove();
+        int score = -negamax<false>(engine, 1 - player, depth - 1 - reduction, ply + 1, -beta, -beta + 1, context);
+        MoveExecutor::unmakeNullMove(engine, undo, player);
+
+        if (context.shared->stop.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        if (score >= beta) {
+            if (depth < verificationDepth) {
+                return beta;
+            }
+            context.verifying = true;
+            score = negamax<false>(engine, player, depth - reduction, ply, beta - 1, beta, context);
+            context.verifying = false;
+            if (score >= beta) {
+                return beta;
+            }
+        }
+    }
+
+    MoveList moves;
+    MoveGenerator::generateAllValidMoves(engine, player, moves);
+
+    if (moves.empty()) {
+        // checkmate scores prefer the shortest mate, stalemate is a draw
+        return inCheck ? -mateScore + ply : 0;
+    }
+
+    // futility pruning: near the leaves, quiet moves cannot lift an evaluation this far below alpha
+    bool futile = selective && options.futilityPruning && depth < 3 && !isMateScore(alpha) &&
+                  staticEval + futilityMargins[depth] <= alpha;
+
+    // the stored move, at the root the best move of the previous iteration, is searched first
+    MovePicker picker(engine, moves, hashMove, context.killers[ply], context.history[player]);
+
+    int originalAlpha = alpha;
+    PackedMove bestMove = PackedMove();
+    PackedMove move;
+    int movesSearched = 0;
+    while (picker.next(move)) {
+        bool quiet = MovePicker::isQuiet(engine, move);
+        UndoRecord undo;
+        MoveExecutor::makeMove(engine, move, player, undo);
+        bool givesCheck = quiet && isInCheck(engine, 1 - player);
+
+        // the first move is always searched, so the node has a score to return
+        if (futile && quiet && !givesCheck && movesSearched > 0) {
+            MoveExecutor::unmakeMove(engine, undo, player);
+            continue;
+        }
+
+        context.table->prefetch(engine.hash);
+        context.played[ply + 1] = move;
+
+        // late-move reductions: quiet moves ordered late are unlikely to be best, so they are searched shallower
+        // first, by more the later they come and the less history they have; a score above alpha is re-searched
+        int reduction = 0;
+        if (options.lateMoveReductions && depth >= reductionDepth && movesSearched >= reductionMoves && quiet && !inCheck && !givesCheck) {
+            int ordering = picker.score();
+            reduction = 1 + (depth >= 6) + (movesSearched >= 12);
+            if (ordering >= MovePicker::killerScore - 1 || ordering >= MovePicker::historyMax / 4) {
+                reduction -= 1;
+            }
+            reduction = std::min(reduction, depth - 2);
+        }
+
+        // principal variation search: the first move is searched with the full window, every later one with a null
+        // window that only proves it no better than alpha; one that turns out better is searched again, at full
+        // depth if it was reduced and then with the full window if this is a principal variation node
+        int score;
+        if (movesSearched == 0) {
+            score = -negamax<pvNode>(engine, 1 - player, depth - 1, ply + 1, -beta, -alpha, context);
+        } else {
+            score = -negamax<false>(engine, 1 - player, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha, context);
+            if (score > alpha && reduction > 0) {
+                score = -negamax<false>(engine, 1 - player, depth - 1, ply + 1, -alpha - 1, -alpha, context);
+            }
+            if (pvNode && score > alpha) {
+                score = -negamax<true>(engine, 1 - player, depth - 1, ply + 1, -beta, -alpha, context);
+            }
+        }
+        MoveExecutor::unmakeMove(engine, undo, player);
+        ++movesSearched;
+
+        // an aborted subtree returns a meaningless score, which must not reach the table
+        if (context.shared->stop.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+
+        if (score > alpha) {
+            alpha = score;
+            bestMove = move;
+
+            // the move and the line below it become the principal variation of this node
+            if (pvNode) {
+                context.pvTable[ply][ply] = move;
+                std::copy(context.pvTable[ply + 1] + ply + 1, context.pvTable[ply + 1] + context.pvLength[ply + 1], context.pvTable[ply] + ply + 1);
+                context.pvLength[ply] = std::max(context.pvLength[ply + 1], ply + 1);
+            }
+
+            if (alpha >= beta) {
+                // remember quiet refutations for sibling nodes and later iterations
+                if (quiet) {
+                    if (context.killers[ply][0] != move) {
+                        context.killers[ply][1] = context.killers[ply][0];
+                        context.killers[ply][0] = move;
+                    }
+                    MovePicker::updateHistory(context.history[player], move, depth);
+                }
+                break;
+            }
+        }
+    }
+
+    Bound bound = alpha >= beta ? Bound::LOWER : (alpha > originalAlpha ? Bound::EXACT : Bound::UPPER);
+    context.table->store(engine.hash, bestMove, scoreToTable(alpha, ply), depth, bound);
+
+    return alpha;
+}
+
+int Search::quiescence(ChessEngine& engine, int player, int ply, int alpha, int beta, Context& context) {
+    countNode(context);
+
+    bool inCheck = isInCheck(engine, player);
+
+    int standPat = evaluate(engine, player);
+    if (ply >= maxPly - 1) {
+        return standPat;
+    }
+
+    // standing pat is only an option when not in check
+    MoveList moves;
+    if (inCheck) {
+        MoveGenerator::generateAllValidMoves(engine, player, moves);
+        if (moves.empty()) {
+            return -mateScore + ply;
+        }
+    } else {
+        if (standPat >= beta) {
+            return beta;
+        }
+        alpha = std::max(alpha, standPat);
+        MoveGenerator::generateCaptures(engine, player, moves);
+    }
+
+    MovePicker picker(engine, moves, PackedMove(), nullptr, nullptr);
+    PackedMove move;
+    while (picker.next(move)) {
+        // delta pruning: even winning the victim for free would not reach alpha
+        if (!inCheck && !move.isPromotion()) {
+            int victim = engine.pieceAt(move.to());
+            int gain = pieceValues[victim != -1 ? victim % 6 : PAWN];
+            if (standPat + gain + deltaMargin <= alpha) {
+                continue;
+            }
+        }
+
+        UndoRecord undo;
+        MoveExecutor::makeMove(engine, move, player, undo);
+        int score = -quiescence(engine, 1 - player, ply + 1, -beta, -alpha, context);
+        MoveExecutor::unmakeMove(engine, undo, player);
+
+        if (context.shared->stop.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+
+        if (score > alpha) {
+            alpha = score;
+            if (alpha >= beta) {
+                break;
+            }
+        }
+    }
+
+    return alpha;
+}
+
+int Search::scoreToTable(int score, int ply) {
+    if (isMateScore(score)) {
+        return score > 0 ? score + ply : score - ply;
+    }
+    return score;
+}
+
+int Search::scoreFromTable(int score, int ply) {
+    if (isMateScore(score)) {
+        return score > 0 ? score - ply : score + ply;
+    }
+    return score;
+}
+
+int Search::evaluate(const ChessEngine& engine, int player) {
+    return Evaluation::evaluate(engine, player);
+}
+
+bool Search::isRepetition(const ChessEngine& engine, const Context& context, int ply) {
+    // positions before the last capture or pawn move cannot repeat; the game history holds the root at its last entry
+    int window = std::min(engine.halfMoveClock, ply + std::min(engine.historyCount, ChessEngine::historySize) - 1);
+    for (int back = 2; back <= window; back += 2) {
+        int index = ply - back;
+        uint64_t earlier = index >= 0 ? context.path[index]
+                                      : engine.positionHistory[(engine.historyCount - 1 + index) & (ChessEngine::historySize - 1)];
+        if (earlier == engine.hash) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Search::hasNonPawnMaterial(const ChessEngine& engine, int player) {
+    return (engine.occupancy[player] & ~(engine.bitboards[player][PAWN] | engine.bitboards[player][KING])) != 0;
+}
+
+bool Search::isInCheck(const ChessEngine& engine, int player) {
+    int kingSquare = __builtin_ctzll(engine.bitboards[player][KING]);
+    return MoveValidator::isSquareAttacked(engine, kingSquare, 1 - player);
+}
+
+void Search::setDeadlines(const SearchLimits& limits, int player, std::chrono::steady_clock::time_point start, Shared& shared) {
+    // kept back from the clock for the overhead between the deadline and the move reaching the opponent
+    const int overhead = 10;
+
+    int soft = 0;
+    int hard = 0;
+    if (limits.moveTime > 0) {
+        soft = hard = limits.moveTime;
+    }
+    if (limits.time[player] > 0) {
+        // spread the clock over the moves left, assuming about thirty more in sudden death, and spend most of the
+        // increment on top; a single move may take up to four shares but never half of what is left
+        int remaining = std::max(1, limits.time[player] - overhead);
+        int movesLeft = limits.movesToGo > 0 ? limits.movesToGo : 30;
+        int share = remaining / movesLeft + limits.increment[player] * 3 / 4;
+        int clockSoft = std::min(share, remaining / 2);
+        int clockHard = std::min(share * 4, remaining / 2);
+        soft = soft > 0 ? std::min(soft, clockSoft) : clockSoft;
+        hard = hard > 0 ? std::min(hard, clockHard) : clockHard;
+    }
+
+    shared.timed = hard > 0;
+    shared.softDeadline = start + std::chrono::milliseconds(std::max(1, soft));
+    shared.hardDeadline = start + std::chrono::milliseconds(std::max(1, hard));
+}
+
+void Search::checkLimits(Context& context) {
+    context.publishedNodes.store(context.nodes, std::memory_order_relaxed);
+
+    // only the calling thread decides, and not before it has a move to return
+    if (context.threadIndex != 0 || !context.completedIteration) {
+        return;
+    }
+
+    Shared& shared = *context.shared;
+    if (shared.limits->nodes > 0) {
+        uint64_t nodes = 0;
+        for (const Context& thread : *shared.contexts) {
+            nodes += thread.publishedNodes.load(std::memory_order_relaxed);
+        }
+        if (nodes >= shared.limits->nodes) {
+            shared.stop.store(true, std::memory_order_relaxed);
+        }
+    }
+    if (shared.timed && std::chrono::steady_clock::now() >= shared.hardDeadline) {
+        shared.stop.store(true, std::memory_order_relaxed);
+    }
+}
+
+void Search::resetOrdering(Context& context) {
+    std::fill(&context.killers[0][0], &context.killers[0][0] + maxPly * 2, PackedMove());
+
+    std::mt19937 random(context.threadIndex);
+    std::uniform_int_distribution<int> noise(0, MovePicker::historyMax / 16);
+    for (int player = 0; player < 2; ++player) {
+        for (int from = 0; from < 64; ++from) {
+            for (int to = 0; to < 64; ++to) {
+                context.history[player][from][to] = context.threadIndex > 0 ? noise(random) : 0;
+            }
+        }
+    }
+}
+
+bool Search::skipsIteration(int threadIndex, int iteration) {
+    if (threadIndex == 0) {
+        return false;
+    }
+    // each pattern searches runs of skipSize iterations and skips the runs in between, shifted by skipPhase
+    int pattern = (threadIndex - 1) % skipPatterns;
+    return ((iteration + skipPhase[pattern]) / skipSize[pattern]) % 2 != 0;
+}
+
+void Search::pinToCore(int core) {
+#ifdef __linux__
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % cores, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
@@ -0,0 +1,335 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "chessengine.hpp"
+#include "searchlimits.hpp"
+#include "transpositiontable.hpp"
+
+/**
+ * @brief Outcome of a search.
+ */
+struct SearchResult {
+    PackedMove bestMove;          // empty if the side to move has no legal move
+    int score;                    // centipawns from the point of view of the side to move, see Search::mateScore
+    int depth;                    // depth of the last completed iteration
+    uint64_t nodes;               // nodes visited over all iterations, by all threads
+    double seconds;               // wall-clock time of the whole search
+    std::vector<PackedMove> pv;   // principal variation, starting with the best move
+};
+
+/**
+ * @class Search
+ * @brief Negamax alpha-beta search with iterative deepening. Each iteration searches one ply deeper than the last
+ * and starts from the previous best move, so a search to depth N also yields the results of every shallower depth.
+ * Nodes are searched as principal variation search: only the first move of a principal variation node gets the full
+ * window, the others are searched with a null window and searched again only if they turn out better. Each iteration
+ * starts with an aspiration window around the score of the previous one, and the principal variation is collected in
+ * a triangular table.
+ * Results are cached in a transposition table, which cuts off transposed subtrees and supplies the move to try first;
+ * the other moves are ordered by MovePicker from per-thread killer and history tables. At the horizon a quiescence
+ * search resolves pending captures, so that leaves are never evaluated in the middle of an exchange.
+ * Above the horizon the tree is narrowed by the selective techniques of SearchOptions: null-move pruning, late-move
+ * reductions, reverse futility pruning and futility pruning.
+ * Several threads search in parallel with Lazy SMP: helper threads search the same root, sharing only the transposition
+ * table, while the calling thread's search provides the result. Each helper skips iterations in its own pattern, so
+ * the threads spread over several depths at once, and starts from its own pseudo-random history values.
+ * The search stops at the limits given in SearchLimits; the calling thread checks them every checkInterval nodes.
+ */
+class Search {
+public:
+    static const int mateScore = 32000;   // score of delivering mate at the root, reduced by one per ply to the mate
+    static const int infinity = 32001;    // bound outside every reachable score
+    static const int maxPly = 64;         // deepest ply the search reaches
+    static const int checkInterval = 1024; // nodes between two checks of the time and node limits, a power of two
+
+    /**
+     * @brief Searches a position to the given depth. The engine is left unchanged.
+     * @param engine The position to search.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The depth of the last iteration, in plies.
+     * @return SearchResult The best move, its score and the principal variation of the deepest iteration.
+     */
+    static SearchResult search(const ChessEngine& engine, int player, int depth);
+
+    /**
+     * @brief Searches a position to the given depth, reusing and filling a transposition table. Passing the same
+     * table for every move of a game carries results over from one move to the next.
+     * @param engine The position to search.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The depth of the last iteration, in plies.
+     * @param table The transposition table.
+     * @return SearchResult The best move, its score and the principal variation of the deepest iteration.
+     */
+    static SearchResult search(const ChessEngine& engine, int player, int depth, TranspositionTable& table);
+
+    /**
+     * @brief Searches a position on several threads. The calling thread searches to the given depth while the
+     * helpers fill the shared transposition table, and the helpers stop as soon as it is done.
+     * @param engine The position to search.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The depth of the last iteration of the calling thread, in plies.
+     * @param table The transposition table shared by all threads.
+     * @param threads The number of threads, including the calling thread.
+     * @param pinThreads Whether to pin each helper thread to its own core (Linux only).
+     * @return SearchResult The result of the calling thread, with the nodes of all threads.
+     */
+    static SearchResult search(const ChessEngine& engine, int player, int depth, TranspositionTable& table, int threads, bool pinThreads = false);
+
+    /**
+     * @brief Searches a position within the given limits, on one or several threads. The first iteration always
+     * completes, so a move is returned however tight the limits are.
+     * @param engine The position to search.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param limits The depth, node and time limits.
+     * @param table The transposition table shared by all threads.
+     * @param threads The number of threads, including the calling thread.
+     * @param pinThreads Whether to pin each helper thread to its own core (Linux only).
+     * @param options The selective techniques to use.
+     * @return SearchResult The result of the last iteration the calling thread completed, with the nodes of all threads.
+     */
+    static SearchResult search(const ChessEngine& engine, int player, const SearchLimits& limits, TranspositionTable& table, int threads = 1,
+                               bool pinThreads = false, const SearchOptions& options = SearchOptions());
+
+    /**
+     * @brief Measures time to depth on the perft reference positions with 1, 2, 4, ... up to the given number of
+     * threads and prints the time, nodes, speed and speedup over one thread for each thread count.
+     * @param out The stream to print to.
+     * @param depth The search depth.
+     * @param threads The largest number of threads.
+     * @param hashMegabytes The transposition table size, cleared before every position.
+     * @param pinThreads Whether to pin the helper threads to cores.
+     */
+    static void runBenchmark(std::ostream& out, int depth, int threads, size_t hashMegabytes = 64, bool pinThreads = false);
+
+    /**
+     * @brief Measures what each selective technique buys: searches the perft reference positions to the given depth
+     * on one thread with every technique on, with each one switched off in turn and with all of them off, and prints
+     * the time, nodes and node count relative to the full-width search for each.
+     * @param out The stream to print to.
+     * @param depth The search depth.
+     * @param hashMegabytes The transposition table size, cleared before every position.
+     */
+    static void runPruningBenchmark(std::ostream& out, int depth, size_t hashMegabytes = 64);
+
+    /**
+     * @brief Checks whether a score announces a forced mate.
+     * @param score The score.
+     * @return true If the score is a mate score for either side.
+     * @return false Otherwise.
+     */
+    static bool isMateScore(int score);
+
+    /**
+     * @brief Formats a score for display, "cp 35" for centipawns or "mate 3" / "mate -2" for moves to mate.
+     * @param score The score.
+     * @return std::string The formatted score.
+     */
+    static std::string scoreToString(int score);
+
+private:
+    struct Context;
+
+    /**
+     * @brief State shared by all threads of one search.
+     */
+    struct Shared {
+        std::atomic<bool> stop;
+        const SearchLimits* limits;
+        const SearchOptions* options;
+        std::vector<Context>* contexts;
+        bool timed;                                          // whether the deadlines apply
+        std::chrono::steady_clock::time_point softDeadline;  // no new iteration starts after it
+        std::chrono::steady_clock::time_point hardDeadline;  // the running iteration is abandoned at it
+    };
+
+    /**
+     * @brief State of the search on one thread.
+     */
+    struct Context {
+        uint64_t nodes;
+        std::atomic<uint64_t> publishedNodes; // nodes as of the last limit check, readable by the calling thread
+        bool completedIteration;              // whether an iteration has completed, before which limits are not checked
+        uint64_t path[maxPly];      // hashes of the positions from the root to the current node, indexed by ply
+        TranspositionTable* table;
+        int threadIndex;            // 0 for the calling thread, 1 and up for the helpers
+        Shared* shared;
+        PackedMove killers[maxPly][2];   // the last two quiet moves that caused a cutoff at each ply
+        PackedMove played[maxPly];       // the move that led to each ply, empty after a null move
+        bool verifying;                  // whether a null-move verification search is running, which allows no null moves
+        int history[2][64][64];          // cutoff history of quiet moves, by player, from and to square
+        PackedMove pvTable[maxPly][maxPly]; // principal variation from each ply, in row ply from column ply on
+        int pvLength[maxPly];            // end of the principal variation in each row of pvTable
+    };
+
+    /**
+     * @brief Turns the time limits into the soft and hard deadlines of a search.
+     * @param limits The limits.
+     * @param player The player to move, whose clock is used (0 for white, 1 for black).
+     * @param start The time the search started.
+     * @param shared Receives the deadlines.
+     */
+    static void setDeadlines(const SearchLimits& limits, int player, std::chrono::steady_clock::time_point start, Shared& shared);
+
+    /**
+     * @brief Publishes the node count of a thread and, on the calling thread, stops the search once the node budget
+     * or the hard deadline is reached. Called every checkInterval nodes.
+     * @param context The state of the search on the thread.
+     */
+    static void checkLimits(Context& context);
+
+    /**
+     * @brief Counts a node, checking the limits every checkInterval nodes.
+     * @param context The state of the search on the thread.
+     */
+    static void countNode(Context& context) {
+        if ((++context.nodes & (checkInterval - 1)) == 0) {
+            checkLimits(context);
+        }
+    }
+
+    /**
+     * @brief Clears the move ordering tables of a thread. Helper threads start from pseudo-random history values
+     * instead, up to a sixteenth of MovePicker::historyMax, so that each of them orders quiet moves differently until
+     * its own cutoffs take over.
+     * @param context The state of the search on the thread.
+     */
+    static void resetOrdering(Context& context);
+
+    /**
+     * @brief Runs iterative deepening on one thread.
+     * @param engine The position to search, copied before searching.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The depth of the last iteration.
+     * @param context The state of the search on this thread.
+     * @return SearchResult The result of the deepest completed iteration, without the node count and time.
+     */
+    static SearchResult iterate(const ChessEngine& engine, int player, int depth, Context& context);
+
+    /**
+     * @brief Searches a node, making and unmaking moves on the given engine. The node type is fixed at compile time:
+     * a principal variation node has an open window and records its line in the PV table, while a null-window node
+     * (beta = alpha + 1) only decides whether the score is above alpha and does no PV bookkeeping.
+     * @tparam pvNode Whether the node is a principal variation node.
+     * @param engine The position, modified during the search and restored on return.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param depth The remaining depth in plies.
+     * @param ply The distance from the root.
+     * @param alpha The lower bound of the search window.
+     * @param beta The upper bound of the search window.
+     * @param context The state of the search, whose PV table receives the principal variation of a PV node.
+     * @return int The score from the point of view of the player to move.
+     */
+    template <bool pvNode>
+    static int negamax(ChessEngine& engine, int player, int depth, int ply, int alpha, int beta, Context& context);
+
+    /**
+     * @brief Searches captures and queen promotions only, until the position is quiet. The side to move may stand
+     * pat on the static evaluation instead of capturing, and captures that cannot raise the score to alpha even by
+     * winning the victim outright are skipped (delta pruning). In check, every evasion is searched instead.
+     * @param engine The position, modified during the search and restored on return.
+     * @param player The player to move (0 for white, 1 for black).
+     * @param ply The distance from the root.
+     * @param alpha The lower bound of the search window.
+     * @param beta The upper bound of the search window.
+     * @param context The state of the search.
+     * @return int The score from the point of view of the player to move.
+     */
+    static int quiescence(ChessEngine& engine, int player, int ply, int alpha, int beta, Context& context);
+
+    /**
+     * @brief Converts a mate score from distance to the root to distance to the node, for storing in the table.
+     * @param score The score.
+     * @param ply The distance from the root.
+     * @return int The score to store.
+     */
+    static int scoreToTable(int score, int ply);
+
+    /**
+     * @brief Converts a stored mate score back from distance to the node to distance to the root.
+     * @param score The stored score.
+     * @param ply The distance from the root.
+     * @return int The score.
+     */
+    static int scoreFromTable(int score, int ply);
+
+    /**
+     * @brief Evaluates a position statically.
+     * @param engine The position.
+     * @param player The player to evaluate for (0 for white, 1 for black).
+     * @return int The score in centipawns from the point of view of the player.
+     */
+    static int evaluate(const ChessEngine& engine, int player);
+
+    /**
+     * @brief Checks whether the current position already occurred since the last irreversible move, either on the
+     * path from the root or earlier in the game. A single repetition is scored as a draw.
+     * @param engine The position.
+     * @param context The state of the search.
+     * @param ply The distance from the root.
+     * @return true If the position is a repetition.
+     * @return false Otherwise.
+     */
+    static bool isRepetition(const ChessEngine& engine, const Context& context, int ply);
+
+    /**
+     * @brief Checks whether a player has a piece other than pawns and the king. Without one, zugzwang is common
+     * enough that null-move pruning is not safe.
+     * @param engine The position.
+     * @param player The player (0 for white, 1 for black).
+     * @return true If the player has a knight, bishop, rook or queen.
+     * @return false Otherwise.
+     */
+    static bool hasNonPawnMaterial(const ChessEngine& engine, int player);
+
+    /**
+     * @brief Checks whether a player's king is attacked.
+     * @param engine The position.
+     * @param player The player (0 for white, 1 for black).
+     * @return true If the player is in check.
+     * @return false Otherwise.
+     */
+    static bool isInCheck(const ChessEngine& engine, int player);
+
+    /**
+     * @brief Restricts the calling thread to one core. Does nothing outside Linux.
+     * @param core The core index, wrapped around the number of cores.
+     */
+    static void pinToCore(int core);
+
+    /**
+     * @brief Decides whether a thread leaves out an iteration of iterative deepening. The calling thread searches
+     * every depth; helper thread i follows skip pattern (i - 1) % skipPatterns, so that helpers reach each depth at
+     * different times instead of all repeating the calling thread's tree.
+     * @param threadIndex The thread, 0 for the calling thread.
+     * @param iteration The depth of the iteration.
+     * @return true If the thread skips the iteration.
+     * @return false Otherwise.
+     */
+    static bool skipsIteration(int threadIndex, int iteration);
+
+    static const int skipPatterns = 20;            // number of iteration skip patterns of the helper threads
+    static const int skipSize[skipPatterns];       // length of the runs of iterations a helper searches and skips
+    static const int skipPhase[skipPatterns];      // offset of the runs
+
+    static const int pieceValues[6];   // centipawn value of each piece type, for delta pruning
+    static const int deltaMargin = 200; // slack on top of the victim's value before a capture counts as hopeless
+    static const int reverseFutilityDepth = 6;     // deepest remaining depth reverse futility pruning applies to
+    static const int reverseFutilityMargin = 120;  // margin per ply of remaining depth the evaluation must exceed beta by
+    static const int futilityMargins[3];           // margin by remaining depth below which quiet moves are skipped
+    static const int nullMoveDepth = 3;            // shallowest remaining depth null-move pruning applies to
+    static const int verificationDepth = 8;        // from this remaining depth on, a null-move cutoff is verified
+    static const int reductionDepth = 3;           // shallowest remaining depth late-move reductions apply to
+    static const int reductionMoves = 3;           // moves searched at full depth before the reductions start
+    static const int aspirationDepth = 4;          // shallowest completed iteration whose score centres an aspiration window
+    static const int aspirationWindow = 50;        // first half-width of an aspiration window, doubled on every failure
+    static const int maxAspirationWindow = 800;    // half-width beyond which a failing side opens completely
+};
+
+#endif // SEARCH_HPP
@@ -0,0 +1,32 @@
+#ifndef SEARCHLIMITS_HPP
+#define SEARCHLIMITS_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Bounds on a search. Every limit that is set applies, and the search stops at whichever is reached first.
+ * A limit of 0 is not set; without any limit the search runs to the deepest ply it supports.
+ * Time limits are turned into two deadlines: after the soft one no new iteration is started, at the hard one the
+ * running iteration is abandoned and the result of the last completed one is returned.
+ */
+struct SearchLimits {
+    int depth = 0;                // deepest iteration, in plies
+    uint64_t nodes = 0;           // node budget over all threads, checked every Search::checkInterval nodes
+    int moveTime = 0;             // milliseconds for this move
+    int time[2] = {0, 0};         // remaining clock time of each player in milliseconds
+    int increment[2] = {0, 0};    // milliseconds added to each player's clock after each of their moves
+    int movesToGo = 0;            // moves until the next time control, 0 for the rest of the game
+};
+
+/**
+ * @brief Selective techniques of the search, each of which can be switched off to measure what it buys.
+ * All of them are on by default; with all of them off the search is a full-width alpha-beta search.
+ */
+struct SearchOptions {
+    bool nullMovePruning = true;         // a pass that still fails high cuts the node off
+    bool lateMoveReductions = true;      // quiet moves late in the order are searched shallower first
+    bool reverseFutilityPruning = true;  // near the leaves, a static evaluation far above beta cuts the node off
+    bool futilityPruning = true;         // near the leaves, quiet moves are skipped when the evaluation is far below alpha
+};
+
+#endif // SEARCHLIMITS_HPP
@@ -0,0 +1,102 @@
+#include "transpositiontable.hpp"
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+
+TranspositionTable::TranspositionTable(size_t megabytes, bool hugePages) : generation(0) {
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+    mask = count - 1;
+    bytes = count * sizeof(Bucket);
+
+    // huge pages need the table aligned to the 2 MB page size, otherwise a cache line is enough
+    size_t alignment = hugePages && bytes >= (2u << 20) ? (2u << 20) : alignof(Bucket);
+    void* memory = nullptr;
+    if (posix_memalign(&memory, alignment, bytes) != 0) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (hugePages) {
+        madvise(memory, bytes, MADV_HUGEPAGE);
+    }
+#endif
+
+    buckets = static_cast<Bucket*>(memory);
+    for (size_t i = 0; i < count; ++i) {
+        new (&buckets[i]) Bucket;
+    }
+    clear();
+}
+
+TranspositionTable::~TranspositionTable() {
+    free(buckets);
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask; ++i) {
+        for (Entry& entry : buckets[i].entries) {
+            entry.key.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    ++generation;
+}
+
+bool TranspositionTable::probe(uint64_t hash, TableEntry& entry) const {
+    const Bucket& bucket = buckets[hash & mask];
+    for (const Entry& slot : bucket.entries) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t key = slot.key.load(std::memory_order_relaxed);
+
+        // a torn or foreign entry fails the key check
+        if ((key ^ data) == hash && boundOf(data) != Bound::NONE) {
+            entry.move = moveOf(data);
+            entry.score = scoreOf(data);
+            entry.depth = depthOf(data);
+            entry.bound = boundOf(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t hash, PackedMove move, int score, int depth, Bound bound) {
+    Bucket& bucket = buckets[hash & mask];
+
+    Entry* victim = nullptr;
+    int victimWorth = 0;
+    for (Entry& slot : bucket.entries) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t key = slot.key.load(std::memory_order_relaxed);
+
+        if ((key ^ data) == hash) {
+            // keep a deeper result from this search unless the new one is exact
+            if (bound != Bound::EXACT && depth < depthOf(data) - 2 && generationOf(data) == generation) {
+                return;
+            }
+            if (move == PackedMove()) {
+                move = moveOf(data);
+            }
+            victim = &slot;
+            break;
+        }
+
+        // empty slots go first, then the shallowest, counting each generation of age as eight plies of depth
+        uint8_t age = static_cast<uint8_t>(generation - generationOf(data));
+        int worth = boundOf(data) == Bound::NONE ? -1024 : depthOf(data) - 8 * age;
+        if (victim == nullptr || worth < victimWorth) {
+            victim = &slot;
+            victimWorth = worth;
+        }
+    }
+
+    uint64_t data = pack(move, score, depth, bound, generation);
+    victim->key.store(hash ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
+}
@@ -0,0 +1,130 @@
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "chessengine.hpp"
+
+/**
+ * @brief How a stored score relates to the true score of the position.
+ */
+enum class Bound : uint8_t {
+    NONE,    // empty entry
+    UPPER,   // every move failed low, the true score is at most the stored one
+    LOWER,   // a move failed high, the true score is at least the stored one
+    EXACT    // the stored score is the true score
+};
+
+/**
+ * @brief Decoded copy of a transposition table entry.
+ */
+struct TableEntry {
+    PackedMove move;   // best or refuting move, empty if none is known
+    int score;
+    int depth;
+    Bound bound;
+};
+
+/**
+ * @class TranspositionTable
+ * @brief Cache of search results keyed by Zobrist hash, shared by all search threads without locks.
+ * Entries are 16 bytes and grouped four to a 64-byte bucket, so a probe touches a single cache line. Each entry
+ * stores the key XORed with the data, so a write torn by a concurrent store fails the key check on probe instead of
+ * returning a wrong result. Entries carry the generation of the search that wrote them, so results from earlier
+ * moves of a game stay usable but are the first to be replaced.
+ */
+class TranspositionTable {
+public:
+    /**
+     * @brief Allocates the table, rounded down to a power of two buckets.
+     * @param megabytes The table size in megabytes.
+     * @param hugePages Whether to ask the kernel to back the table with huge pages (Linux only, advisory).
+     */
+    explicit TranspositionTable(size_t megabytes, bool hugePages = false);
+
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    /**
+     * @brief Empties the table and resets the generation.
+     */
+    void clear();
+
+    /**
+     * @brief Starts a new generation. Called once per search, so entries age from one move of a game to the next.
+     */
+    void newSearch();
+
+    /**
+     * @brief Looks up a position.
+     * @param hash The Zobrist hash of the position.
+     * @param entry Receives the stored result on a hit.
+     * @return true If the position was found.
+     * @return false Otherwise.
+     */
+    bool probe(uint64_t hash, TableEntry& entry) const;
+
+    /**
+     * @brief Stores a search result. An existing entry for the same position is only replaced by a result that is
+     * exact, about as deep, or from a newer search; otherwise the shallowest and oldest entry of the bucket goes.
+     * @param hash The Zobrist hash of the position.
+     * @param move The best or refuting move, or an empty move to keep the stored one.
+     * @param score The score, already adjusted for the distance to mate from this position.
+     * @param depth The remaining depth the score was searched to.
+     * @param bound How the score relates to the true score.
+     */
+    void store(uint64_t hash, PackedMove move, int score, int depth, Bound bound);
+
+    /**
+     * @brief Starts loading the bucket of a position into the cache, so a probe shortly after does not stall.
+     * @param hash The Zobrist hash of the position.
+     */
+    void prefetch(uint64_t hash) const { __builtin_prefetch(&buckets[hash & mask]); }
+
+    /**
+     * @brief Gets the number of entries in the table.
+     * @return size_t The number of entries.
+     */
+    size_t size() const { return (mask + 1) * bucketSize; }
+
+private:
+    static const int bucketSize = 4;
+
+    struct Entry {
+        std::atomic<uint64_t> key;  // hash XOR data
+        std::atomic<uint64_t> data; // move in bits 0-15, score 16-31, depth 32-39, bound 40-41, generation 48-55
+    };
+
+    struct alignas(64) Bucket {
+        Entry entries[bucketSize];
+    };
+
+    static uint64_t pack(PackedMove move, int score, int depth, Bound bound, uint8_t generation) {
+        return static_cast<uint64_t>(move.data) |
+               static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16 |
+               static_cast<uint64_t>(depth & 0xFF) << 32 |
+               static_cast<uint64_t>(bound) << 40 |
+               static_cast<uint64_t>(generation) << 48;
+    }
+
+    static PackedMove moveOf(uint64_t data) {
+        PackedMove move;
+        move.data = static_cast<uint16_t>(data);
+        return move;
+    }
+
+    static int scoreOf(uint64_t data) { return static_cast<int16_t>(data >> 16); }
+    static int depthOf(uint64_t data) { return static_cast<int>((data >> 32) & 0xFF); }
+    static Bound boundOf(uint64_t data) { return static_cast<Bound>((data >> 40) & 0x3); }
+    static uint8_t generationOf(uint64_t data) { return static_cast<uint8_t>(data >> 48); }
+
+    Bucket* buckets;
+    size_t mask;
+    size_t bytes;
+    uint8_t generation;
+};
+
+#endif // TRANSPOSITIONTABLE_HPP
@@ -1,4 +1,5 @@
 #include "utils.hpp"
+#include "evaluation.hpp"
 #include "movegenerator.hpp"
 #include "movevalidator.hpp"
 #include <iostream>
@@ -11,29 +12,15 @@ void Utils::printBoard(const ChessEngine& engine) {
         {'p', 'n', 'b', 'r', 'q', 'k'}  // black pieces
     };
 
-    uint64_t pieces[2][6] = {
-        {engine.whitePawns, engine.whiteKnights, engine.whiteBishops, engine.whiteRooks, engine.whiteQueens, engine.whiteKing},
-        {engine.blackPawns, engine.blackKnights, engine.blackBishops, engine.blackRooks, engine.blackQueens, engine.blackKing}
-    };
-
     std::cout << "  a b c d e f g h" << std::endl;
     for (int rank = 7; rank >= 0; --rank) {
         std::cout << rank + 1 << " ";
         for (int file = 0; file < 8; ++file) {
-            int square = rank * 8 + file;
-            bool empty = true;
-            for (int color = 0; color < 2; ++color) {
-                for (int piece = 0; piece < 6; ++piece) {
-                    if (pieces[color][piece] & (1ULL << square)) {
-                        std::cout << pieceChars[color][piece] << " ";
-                        empty = false;
-                        break;
-                    }
-                }
-                if (!empty) break;
-            }
-            if (empty) {
+            int piece = engine.pieceAt(rank * 8 + file);
+            if (piece == -1) {
                 std::cout << ". ";
+            } else {
+                std::cout << pieceChars[piece / 6][piece % 6] << " ";
             }
         }
         std::cout << rank + 1 << std::endl;
@@ -54,66 +41,38 @@ void Utils::printBitboard(uint64_t bitboard) {
 }
 
 int Utils::evaluateBoard(const ChessEngine& engine, int player) {
-    const int pawnValue = 1;
-    const int knightValue = 3;
-    const int bishopValue = 3;
-    const int rookValue = 5;
-    const int queenValue = 9;
-
-    int whiteScore = 0;
-    int blackScore = 0;
-
-    whiteScore += __builtin_popcountll(engine.whitePawns) * pawnValue;
-    whiteScore += __builtin_popcountll(engine.whiteKnights) * knightValue;
-    whiteScore += __builtin_popcountll(engine.whiteBishops) * bishopValue;
-    whiteScore += __builtin_popcountll(engine.whiteRooks) * rookValue;
-    whiteScore += __builtin_popcountll(engine.whiteQueens) * queenValue;
-
-    blackScore += __builtin_popcountll(engine.blackPawns) * pawnValue;
-    blackScore += __builtin_popcountll(engine.blackKnights) * knightValue;
-    blackScore += __builtin_popcountll(engine.blackBishops) * bishopValue;
-    blackScore += __builtin_popcountll(engine.blackRooks) * rookValue;
-    blackScore += __builtin_popcountll(engine.blackQueens) * queenValue;
-
-    // return the evaluation from the perspective of the player
-    return (player == 0) ? (whiteScore - blackScore) : (blackScore - whiteScore);
+    return Evaluation::evaluate(engine, player);
 }
 
-std::string Utils::getGameStatus(const ChessEngine& engine, int player) {
-    if (engine.getGameStatus() == GameStatus::BLACK_RESIGNS) {
-        return "Black resigns";
-    } else if (engine.getGameStatus() == GameStatus::WHITE_RESIGNS) {
-        return "White resigns";
-    }
-
+GameStatus Utils::getGameStatus(const ChessEngine& engine, int player) {
     int opponent = 1 - player;
-    std::vector<Move> opponentMoves = MoveGenerator::generateAllValidMoves(engine, opponent);
-    
-    if (opponentMoves.empty()) {
+
+    // the first legal move found settles it, there is no need to generate them all
+    if (!MoveGenerator::hasAnyLegalMove(engine, opponent)) {
         // check if the opponent's king is in check
-        uint64_t opponentKing = (opponent == 0) ? engine.whiteKing : engine.blackKing;
+        uint64_t opponentKing = engine.pieces(opponent, KING);
         int kingPosition = __builtin_ffsll(opponentKing) - 1;
 
         if (MoveValidator::isSquareAttacked(engine, kingPosition, player)) {
-            return (player == 0) ? "Black is checkmated" : "White is checkmated";
+            return (player == 0) ? GameStatus::BLACK_CHECKMATED : GameStatus::WHITE_CHECKMATED;
         } else {
-            return "Stalemate";
+            return GameStatus::STALEMATE;
         }
     }
 
     if (Utils::isInsufficientMaterial(engine)) {
-        return "Insufficient material";
+        return GameStatus::INSUFFICIENT_MATERIAL;
     }
 
     if (engine.isRepetitionDraw()) {
-        return "Threefold repetition";
+        return GameStatus::THREEFOLD_REPETITION;
     }
 
     if (engine.isFiftyMoveDraw()) {
-        return "Fifty move draw";
+        return GameStatus::FIFTY_MOVE_DRAW;
     }
 
-    return "Game in progress";
+    return GameStatus::IN_PROGRESS;
 }
 
 void Utils::printHelp() {
@@ -124,7 +83,26 @@ void Utils::printHelp() {
               << "-n --new    For a new game session.\n"
               << "-f --file   The path to the input game file. Please note that if the game is finished the program will \n"
               << "-l --log    The path to the output log file.\n"
-              << "-e --eval   Returns evaluation of a player's position based on the provided ID - 0 = white, 1 = black.\n";
+              << "-e --eval   Returns evaluation of a player's position based on the provided ID - 0 = white, 1 = black.\n"
+              << "--mode      Starts a game in the given mode: hvh (human vs human), hva (human vs AI), ava (AI vs AI),\n"
+              << "            hvs (human vs search), svs (search vs search).\n"
+              << "--fen       Sets up the position given in Forsyth-Edwards Notation for the following options.\n"
+              << "--perft     Counts the leaf nodes to the given depth with a per-move breakdown and nodes/second.\n"
+              << "--perft-suite Checks move generation against the reference perft positions.\n"
+              << "--threads   Sets the number of threads used by --perft, --perft-suite, --bench and the search player, given before them.\n"
+              << "--pin       Pins the helper threads of --bench and the search player to cores.\n"
+              << "--bench     Measures search time to --depth on the reference positions with 1, 2, 4, ... up to --threads threads.\n"
+              << "--bench-pruning Measures nodes and time to --depth on the reference positions with each selective technique\n"
+              << "            switched off in turn.\n"
+              << "--disable   Switches off a selective technique of the search player: nmp (null-move pruning),\n"
+              << "            lmr (late-move reductions), rfp (reverse futility pruning), fp (futility pruning).\n"
+              << "--depth     Sets the number of plies the search player looks ahead (default 4, 0 for no limit), given before --mode.\n"
+              << "--movetime  Limits each move of the search player to the given number of milliseconds.\n"
+              << "--nodes     Limits each move of the search player to the given number of nodes.\n"
+              << "--clock     Gives the search player a game clock of the given number of milliseconds.\n"
+              << "--inc       Adds the given number of milliseconds to the search player's clock after each move.\n"
+              << "--hash      Sets the transposition table size of the search player in megabytes (default 64).\n"
+              << "--headless  Turns off the move and board output of the options that follow it.\n";
 }
 
 std::string Utils::positionToUCI(int position) {
@@ -133,6 +111,14 @@ std::string Utils::positionToUCI(int position) {
     return std::string(1, file) + std::string(1, rank);
 }
 
+std::string Utils::moveToUCI(PackedMove move) {
+    std::string notation = positionToUCI(move.from()) + positionToUCI(move.to());
+    if (move.isPromotion()) {
+        notation += move.promotion();
+    }
+    return notation;
+}
+
 
 void Utils::printMoves(const std::vector<Move>& moves) {
     for (const Move& move : moves) {
@@ -141,17 +127,17 @@ void Utils::printMoves(const std::vector<Move>& moves) {
 }
 
 bool Utils::isInsufficientMaterial(const ChessEngine& engine) {
-    int whitePawnCount = __builtin_popcountll(engine.whitePawns);
-    int whiteKnightCount = __builtin_popcountll(engine.whiteKnights);
-    int whiteBishopCount = __builtin_popcountll(engine.whiteBishops);
-    int whiteRookCount = __builtin_popcountll(engine.whiteRooks);
-    int whiteQueenCount = __builtin_popcountll(engine.whiteQueens);
-
-    int blackPawnCount = __builtin_popcountll(engine.blackPawns);
-    int blackKnightCount = __builtin_popcountll(engine.blackKnights);
-    int blackBishopCount = __builtin_popcountll(engine.blackBishops);
-    int blackRookCount = __builtin_popcountll(engine.blackRooks);
-    int blackQueenCount = __builtin_popcountll(engine.blackQueens);
+    int whitePawnCount = __builtin_popcountll(engine.whitePawns());
+    int whiteKnightCount = __builtin_popcountll(engine.whiteKnights());
+    int whiteBishopCount = __builtin_popcountll(engine.whiteBishops());
+    int whiteRookCount = __builtin_popcountll(engine.whiteRooks());
+    int whiteQueenCount = __builtin_popcountll(engine.whiteQueens());
+
+    int blackPawnCount = __builtin_popcountll(engine.blackPawns());
+    int blackKnightCount = __builtin_popcountll(engine.blackKnights());
+    int blackBishopCount = __builtin_popcountll(engine.blackBishops());
+    int blackRookCount = __builtin_popcountll(engine.blackRooks());
+    int blackQueenCount = __builtin_popcountll(engine.blackQueens());
 
     // check if there are any pawns, rooks, or queens on the board
     if (whitePawnCount > 0 || blackPawnCount > 0 || whiteRookCount > 0 || blackRookCount > 0 ||
@@ -179,8 +165,8 @@ bool Utils::isInsufficientMaterial(const ChessEngine& engine) {
         whiteBishopCount == 1 && blackBishopCount == 1) {
         
         // check if both bishops are on the same color
-        int whiteBishopSquare = __builtin_ffsll(engine.whiteBishops) - 1;
-        int blackBishopSquare = __builtin_ffsll(engine.blackBishops) - 1;
+        int whiteBishopSquare = __builtin_ffsll(engine.whiteBishops()) - 1;
+        int blackBishopSquare = __builtin_ffsll(engine.blackBishops()) - 1;
         
         bool whiteBishopColor = (whiteBishopSquare / 8 + whiteBishopSquare % 8) % 2;
         bool blackBishopColor = (blackBishopSquare / 8 + blackBishopSquare % 8) % 2;
@@ -24,20 +24,22 @@ public:
     static void printBitboard(uint64_t bitboard);
 
     /**
-     * @brief Evaluates the current board state from the perspective of a player.
+     * @brief Evaluates the current board state from the perspective of a player, by material and piece placement
+     * tapered between the middlegame and the endgame (see Evaluation).
      * @param engine The chess engine containing the game state.
      * @param player The player to evaluate the board for (0 for white, 1 for black).
-     * @return The evaluation score.
+     * @return The evaluation score in centipawns.
      */
     static int evaluateBoard(const ChessEngine& engine, int player);
 
     /**
-     * @brief Gets the current game status.
+     * @brief Works out the game status from the board after a move. Resignations and draw agreements are not board
+     * properties and are tracked by the engine itself.
      * @param engine The chess engine containing the game state.
-     * @param player The player to get the game status for (0 for white, 1 for black).
-     * @return The game status as a string.
+     * @param player The player who made the last move (0 for white, 1 for black).
+     * @return The game status.
      */
-    static std::string getGameStatus(const ChessEngine& engine, int player);
+    static GameStatus getGameStatus(const ChessEngine& engine, int player);
 
     /**
      * @brief Prints the help message.
@@ -51,6 +53,13 @@ public:
      */
     static std::string positionToUCI(int position);
 
+    /**
+     * @brief Converts a move to UCI notation, including the promotion piece.
+     * @param move The move to convert.
+     * @return The move in UCI notation, e.g. "e2e4" or "a7a8q".
+     */
+    static std::string moveToUCI(PackedMove move);
+
     /**
      * @brief Prints a list of moves.
      * @param moves The list of moves to print.
@@ -0,0 +1,3 @@
+#include "zobrist.hpp"
+
+constexpr ZobristKeys Zobrist::keys;
@@ -0,0 +1,92 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+
+/**
+ * @brief The random keys Zobrist hashes are built from. Generated at compile time from a fixed seed, so a hash means
+ * the same position in every process and on every machine.
+ */
+struct ZobristKeys {
+    uint64_t pieces[12][64]; // 6 pieces for each color on 64 squares
+    uint64_t castling[4];    // 4 castling rights (white queenside, white kingside, black queenside, black kingside)
+    uint64_t enPassant[8];   // 8 possible en passant files
+    uint64_t side;           // black to move
+
+    /**
+     * @brief Fills every key from a splitmix64 sequence.
+     * @param seed The starting state of the generator.
+     * @return The keys.
+     */
+    static constexpr ZobristKeys generate(uint64_t seed) {
+        ZobristKeys keys{};
+        for (int piece = 0; piece < 12; ++piece) {
+            for (int square = 0; square < 64; ++square) {
+                keys.pieces[piece][square] = next(seed);
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            keys.castling[i] = next(seed);
+        }
+        for (int i = 0; i < 8; ++i) {
+            keys.enPassant[i] = next(seed);
+        }
+        keys.side = next(seed);
+        return keys;
+    }
+
+private:
+    /**
+     * @brief Advances the splitmix64 generator.
+     * @param state The generator state, advanced in place.
+     * @return The next pseudo-random number.
+     */
+    static constexpr uint64_t next(uint64_t& state) {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+/**
+ * @class Zobrist
+ * @brief The shared Zobrist key table, baked into the binary at compile time.
+ */
+class Zobrist {
+public:
+    /**
+     * @brief Gets the key of a piece on a square.
+     * @param piece The piece index (0-5 white pawn to king, 6-11 black pawn to king).
+     * @param square The square index (0-63).
+     * @return The key.
+     */
+    static constexpr uint64_t piece(int piece, int square) { return keys.pieces[piece][square]; }
+
+    /**
+     * @brief Gets the key of a castling right.
+     * @param right The castling right (0-3, white queenside, white kingside, black queenside, black kingside).
+     * @return The key.
+     */
+    static constexpr uint64_t castling(int right) { return keys.castling[right]; }
+
+    /**
+     * @brief Gets the key of an en passant file.
+     * @param file The file (0-7) of the en passant target.
+     * @return The key.
+     */
+    static constexpr uint64_t enPassant(int file) { return keys.enPassant[file]; }
+
+    /**
+     * @brief Gets the key toggled when black is to move.
+     * @return The key.
+     */
+    static constexpr uint64_t side() { return keys.side; }
+
+private:
+    static constexpr uint64_t seed = 0x436865737369655AULL;
+    static constexpr ZobristKeys keys = ZobristKeys::generate(seed);
+};
+
+#endif // ZOBRIST_HPP
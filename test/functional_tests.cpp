@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 #include "chessengine.hpp"
 #include "utils.hpp"
+#include "perft.hpp"
+#include "movegenerator.hpp"
+#include "search.hpp"
+#include <algorithm>
 
 // functional test for an incomplete game
 TEST(FunctionalTest, GameInProgress) {
@@ -36,4 +40,202 @@ TEST(FunctionalTest, CheckMate) {
     // check game status after moves
     GameStatus status = engine.getGameStatus();
     EXPECT_EQ(status, GameStatus::BLACK_CHECKMATED);
-}
\ No newline at end of file
+}
+// functional test for a draw by threefold repetition of the starting position
+TEST(FunctionalTest, ThreefoldRepetition) {
+    ChessEngine engine;
+    engine.newGame();
+
+    std::vector<std::string> moves = {"g1f3", "g8f6", "f3g1", "f6g8", "g1f3", "g8f6", "f3g1", "f6g8"};
+    int player = 0;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        EXPECT_EQ(engine.getGameStatus(), GameStatus::IN_PROGRESS) << "before move " << i;
+        engine.makeMove(Move(moves[i]), player);
+        player = 1 - player;
+    }
+
+    // the starting position has now occurred for the third time
+    EXPECT_TRUE(engine.isRepetitionDraw());
+    EXPECT_EQ(engine.getGameStatus(), GameStatus::THREEFOLD_REPETITION);
+}
+
+// functional test comparing perft node counts against the reference positions
+TEST(PerftTest, ReferencePositions) {
+    for (int i = 0; i < Perft::referencePositionCount; ++i) {
+        const PerftPosition& position = Perft::referencePositions[i];
+        ChessEngine engine;
+        int player = engine.loadFEN(position.fen);
+        EXPECT_EQ(Perft::count(engine, player, position.depth), position.nodes) << position.name;
+    }
+}
+
+// functional test checking that the threaded, hashed perft agrees with the reference counts
+TEST(PerftTest, ParallelMatchesReference) {
+    for (int i = 0; i < Perft::referencePositionCount; ++i) {
+        const PerftPosition& position = Perft::referencePositions[i];
+        ChessEngine engine;
+        int player = engine.loadFEN(position.fen);
+        PerftResult result = Perft::parallelCount(engine, player, position.depth, 4, 16);
+        EXPECT_EQ(result.nodes, position.nodes) << position.name;
+
+        uint64_t threadTotal = 0;
+        for (uint64_t nodes : result.threadNodes) {
+            threadTotal += nodes;
+        }
+        EXPECT_EQ(threadTotal, position.nodes) << position.name;
+    }
+}
+
+// functional test for the FEN loader rejecting malformed positions
+TEST(PerftTest, InvalidFEN) {
+    ChessEngine engine;
+    EXPECT_THROW(engine.loadFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1"), std::invalid_argument);
+    EXPECT_THROW(engine.loadFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1"), std::invalid_argument);
+}
+
+// functional test for the search finding a back-rank mate and announcing it
+TEST(SearchTest, FindsMateInOne) {
+    ChessEngine engine;
+    int player = engine.loadFEN("6k1/5ppp/8/8/8/8/8/R6K w - - 0 1");
+    SearchResult result = Search::search(engine, player, 3);
+
+    EXPECT_EQ(result.bestMove, PackedMove(0, 56));
+    EXPECT_EQ(result.score, Search::mateScore - 1);
+    EXPECT_EQ(Search::scoreToString(result.score), "mate 1");
+    ASSERT_EQ(result.pv.size(), 1u);
+
+    // a mate delivered on the hundredth half-move is still a mate, not a fifty-move draw
+    player = engine.loadFEN("6k1/5ppp/8/8/8/8/8/R6K w - - 99 80");
+    result = Search::search(engine, player, 3);
+    EXPECT_EQ(result.bestMove, PackedMove(0, 56));
+    EXPECT_EQ(result.score, Search::mateScore - 1);
+}
+
+// functional test for the search winning material that the greedy player would also see, and not hanging it back
+TEST(SearchTest, WinsUndefendedQueen) {
+    ChessEngine engine;
+    int player = engine.loadFEN("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    SearchResult result = Search::search(engine, player, 4);
+
+    EXPECT_EQ(result.bestMove, PackedMove(11, 35));
+    EXPECT_GT(result.score, 0);
+    EXPECT_EQ(result.depth, 4);
+    EXPECT_EQ(result.pv.front(), result.bestMove);
+
+    // the searched engine is left as it was
+    EXPECT_EQ(engine.pieceAt(35), 6 + QUEEN);
+}
+
+// functional test for the transposition table carrying results over to the next search of a game
+TEST(SearchTest, TableCarriesOver) {
+    ChessEngine engine;
+    int player = engine.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    TranspositionTable table(16);
+
+    SearchResult first = Search::search(engine, player, 4, table);
+    SearchResult second = Search::search(engine, player, 4, table);
+
+    EXPECT_EQ(second.score, first.score);
+    EXPECT_LT(second.nodes, first.nodes);
+}
+
+// functional test for the Lazy SMP search agreeing with the single-threaded one on forced lines
+TEST(SearchTest, ParallelFindsSameMoves) {
+    ChessEngine engine;
+    TranspositionTable table(16);
+
+    int player = engine.loadFEN("6k1/5ppp/8/8/8/8/8/R6K w - - 0 1");
+    SearchResult mate = Search::search(engine, player, 4, table, 4);
+    EXPECT_EQ(mate.bestMove, PackedMove(0, 56));
+    EXPECT_EQ(mate.score, Search::mateScore - 1);
+
+    player = engine.loadFEN("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    SearchResult capture = Search::search(engine, player, 4, table, 4);
+    EXPECT_EQ(capture.bestMove, PackedMove(11, 35));
+    EXPECT_EQ(capture.depth, 4);
+}
+
+// functional test for the quiescence search seeing the recapture beyond the horizon
+TEST(SearchTest, QuiescenceSeesRecapture) {
+    ChessEngine engine;
+    int player = engine.loadFEN("4k3/8/4p3/3p4/8/8/8/3QK3 w - - 0 1");
+    SearchResult result = Search::search(engine, player, 1);
+
+    // taking the defended pawn would lose the queen to exd5, keeping it leaves a queen against two pawns
+    EXPECT_NE(result.bestMove, PackedMove(3, 35));
+    EXPECT_GT(result.score, 600);
+}
+
+// functional test for the node and time limits stopping an unbounded search with a move
+TEST(SearchTest, LimitsStopSearch) {
+    ChessEngine engine;
+    int player = engine.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    TranspositionTable table(16);
+
+    SearchLimits nodeLimit;
+    nodeLimit.nodes = 20000;
+    SearchResult result = Search::search(engine, player, nodeLimit, table);
+    EXPECT_LE(result.nodes, nodeLimit.nodes + Search::checkInterval);
+    EXPECT_GE(result.depth, 1);
+    EXPECT_FALSE(result.pv.empty());
+
+    SearchLimits timeLimit;
+    timeLimit.moveTime = 50;
+    result = Search::search(engine, player, timeLimit, table, 2);
+    EXPECT_LT(result.seconds, 0.5);
+    EXPECT_GE(result.depth, 1);
+
+    // a move never takes more than half of what is left on the clock
+    SearchLimits clock;
+    clock.time[0] = 600;
+    clock.increment[0] = 100;
+    result = Search::search(engine, player, clock, table);
+    EXPECT_LT(result.seconds, 0.5);
+    EXPECT_FALSE(result.pv.empty());
+}
+
+// functional test for the selective techniques narrowing the tree without losing forced lines
+TEST(SearchTest, SelectiveSearch) {
+    ChessEngine engine;
+    TranspositionTable table(16);
+    SearchLimits limits;
+    limits.depth = 5;
+
+    SearchOptions fullWidth;
+    fullWidth.nullMovePruning = fullWidth.lateMoveReductions = false;
+    fullWidth.reverseFutilityPruning = fullWidth.futilityPruning = false;
+
+    int player = engine.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    SearchResult full = Search::search(engine, player, limits, table, 1, false, fullWidth);
+    table.clear();
+    SearchResult selective = Search::search(engine, player, limits, table);
+    EXPECT_LT(selective.nodes, full.nodes / 2);
+    EXPECT_EQ(selective.depth, 5);
+
+    player = engine.loadFEN("6k1/5ppp/8/8/8/8/8/R6K w - - 0 1");
+    SearchResult mate = Search::search(engine, player, limits, table);
+    EXPECT_EQ(mate.bestMove, PackedMove(0, 56));
+    EXPECT_EQ(mate.score, Search::mateScore - 1);
+
+    player = engine.loadFEN("4k3/8/4p3/3p4/8/8/8/3QK3 w - - 0 1");
+    SearchResult quiet = Search::search(engine, player, limits, table);
+    EXPECT_NE(quiet.bestMove, PackedMove(3, 35));
+}
+
+// functional test for the principal variation being a full, legal line from the root
+TEST(SearchTest, PrincipalVariationIsLegal) {
+    ChessEngine engine;
+    engine.setHeadless(true);
+    int player = engine.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    SearchResult result = Search::search(engine, player, 6);
+
+    ASSERT_GE(result.pv.size(), 4u);
+    EXPECT_EQ(result.pv.front(), result.bestMove);
+    for (PackedMove move : result.pv) {
+        MoveList moves;
+        MoveGenerator::generateAllValidMoves(engine, player, moves);
+        ASSERT_NE(std::find(moves.begin(), moves.end(), move), moves.end());
+        engine.makeMove(move, player);
+        player = 1 - player;
+    }
+}
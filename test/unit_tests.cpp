@@ -1,6 +1,15 @@
 #include <gtest/gtest.h>
 #include "chessengine.hpp"
 #include "movevalidator.hpp"
+#include "attacks.hpp"
+#include "movegenerator.hpp"
+#include "moveexecutor.hpp"
+#include "zobrist.hpp"
+#include "transpositiontable.hpp"
+#include "movepicker.hpp"
+#include "evaluation.hpp"
+#include <random>
+#include <vector>
 
 // test move validation for various scenarios
 TEST(MoveValidatorTest, ValidMoves) {
@@ -27,4 +36,457 @@ TEST(MoveValidatorTest, InvalidMoves) {
     // test invalid knight move
     move = Move("g1g3");
     EXPECT_FALSE(MoveValidator::isValidMove(move, 0, engine));
-}
\ No newline at end of file
+}
+
+// test magic bitboard lookups for sliding pieces
+TEST(AttacksTest, SlidingAttacks) {
+    // rook on a1 on an empty board sees the whole a-file and first rank
+    EXPECT_EQ(Attacks::rookAttacks(0, 0), 0x01010101010101FEULL);
+
+    // bishop on d4 blocked on f6 and b2, blockers themselves are included
+    uint64_t blockers = (1ULL << 45) | (1ULL << 9);
+    EXPECT_EQ(Attacks::bishopAttacks(27, blockers),
+              (1ULL << 36) | (1ULL << 45) | (1ULL << 18) | (1ULL << 9) |
+              (1ULL << 34) | (1ULL << 41) | (1ULL << 48) | (1ULL << 20) | (1ULL << 13) | (1ULL << 6));
+
+    // queen is the union of both
+    EXPECT_EQ(Attacks::queenAttacks(27, blockers), Attacks::rookAttacks(27, blockers) | Attacks::bishopAttacks(27, blockers));
+}
+
+// test the compile-time knight, king and pawn tables
+TEST(AttacksTest, LeaperAttacks) {
+    // the tables are constant expressions, so these are checked by the compiler
+    static_assert(Attacks::knightAttacks(0) == ((1ULL << 10) | (1ULL << 17)), "knight on a1");
+    static_assert(Attacks::kingAttacks(63) == ((1ULL << 62) | (1ULL << 55) | (1ULL << 54)), "king on h8");
+    static_assert(Attacks::pawnAttacks(0, 15) == (1ULL << 22), "white pawn on h2 does not wrap to the a-file");
+    static_assert(Attacks::pawnAttacks(1, 52) == ((1ULL << 43) | (1ULL << 45)), "black pawn on e7");
+
+    EXPECT_EQ(__builtin_popcountll(Attacks::knightAttacks(27)), 8);
+    EXPECT_EQ(__builtin_popcountll(Attacks::kingAttacks(27)), 8);
+}
+
+// test in-place generation into a fixed-capacity move list
+TEST(MoveGeneratorTest, StartingPositionMoves) {
+    ChessEngine engine;
+    engine.newGame();
+
+    MoveList moves;
+    MoveGenerator::generateAllMoves(engine, 0, moves);
+    EXPECT_EQ(moves.size(), 20);
+
+    // appending keeps what is already in the list
+    MoveGenerator::generateAllMoves(engine, 1, moves);
+    EXPECT_EQ(moves.size(), 40);
+
+    // the vector API returns the same moves
+    EXPECT_EQ(MoveGenerator::generateAllValidMoves(engine, 0).size(), 20u);
+}
+
+// test the packed move encoding and the non-throwing UCI parser
+TEST(PackedMoveTest, ParseAndConvert) {
+    PackedMove move;
+    ASSERT_TRUE(PackedMove::parse("e2e4", 4, move));
+    EXPECT_EQ(move.from(), 12);
+    EXPECT_EQ(move.to(), 28);
+    EXPECT_FALSE(move.isPromotion());
+    EXPECT_EQ(sizeof(PackedMove), 2u);
+
+    // the text does not have to be null-terminated
+    ASSERT_TRUE(PackedMove::parse("a7a8qxyz", 5, move));
+    EXPECT_EQ(move, PackedMove(48, 56, PackedMove::PROMOTE_QUEEN));
+    EXPECT_EQ(move.promotion(), 'q');
+
+    // malformed input is reported, not thrown
+    EXPECT_FALSE(PackedMove::parse("e2e9", 4, move));
+    EXPECT_FALSE(PackedMove::parse("a7a8k", 5, move));
+    EXPECT_FALSE(PackedMove::parse("e2", 2, move));
+
+    // conversions at the I/O boundary round-trip
+    Move uci("b7b8n");
+    EXPECT_EQ(uci.toPacked(), PackedMove(49, 57, PackedMove::PROMOTE_KNIGHT));
+    EXPECT_EQ(Move(uci.toPacked()).promotion, 'n');
+    EXPECT_THROW(Move("z9z9"), std::invalid_argument);
+}
+
+// test that a pinned piece only moves along the pin line
+TEST(MoveGeneratorTest, PinnedPieceStaysOnLine) {
+    ChessEngine engine;
+    engine.loadFEN("k3r3/8/8/8/8/8/4R3/4K3 w - - 0 1"); // the rook on e2 is pinned by the rook on e8
+
+    MoveList moves;
+    MoveGenerator::generateAllValidMoves(engine, 0, moves);
+
+    // four king moves plus e3-e8 for the rook
+    EXPECT_EQ(moves.size(), 10);
+    for (PackedMove move : moves) {
+        if (move.from() == 12) {
+            EXPECT_EQ(move.to() % 8, 4);
+        }
+    }
+}
+
+// test early-exit legal move detection and the status it feeds
+TEST(MoveGeneratorTest, HasAnyLegalMove) {
+    ChessEngine engine;
+    engine.newGame();
+    EXPECT_TRUE(MoveGenerator::hasAnyLegalMove(engine, 0));
+
+    engine.loadFEN("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3"); // fool's mate
+    EXPECT_FALSE(MoveGenerator::hasAnyLegalMove(engine, 0));
+    EXPECT_EQ(engine.getGameStatus(), GameStatus::WHITE_CHECKMATED);
+
+    engine.loadFEN("k7/2Q5/1K6/8/8/8/8/8 b - - 0 1"); // black to move has no legal moves and is not in check
+    EXPECT_FALSE(MoveGenerator::hasAnyLegalMove(engine, 1));
+    EXPECT_EQ(engine.getGameStatus(), GameStatus::STALEMATE);
+}
+
+// test attacker lookups and castling through an attacked square
+TEST(MoveValidatorTest, AttackersAndCastling) {
+    ChessEngine engine;
+    engine.newGame();
+
+    uint64_t occupied = engine.allPieces();
+
+    // f3 is covered by the e2 and g2 pawns and the g1 knight; e4 is only reachable by a push, which is not an attack
+    EXPECT_EQ(MoveValidator::attackersTo(engine, 21, occupied), (1ULL << 12) | (1ULL << 14) | (1ULL << 6));
+    EXPECT_FALSE(MoveValidator::isSquareAttacked(engine, 28, 0));
+
+    // clear f1/g1 and aim a black rook down the f-file
+    engine.loadFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPP1PP/RNBQK2R w KQkq - 0 1");
+    EXPECT_TRUE(MoveValidator::canCastleKingside(0, engine));
+    engine.loadFEN("rnbqkbnr/pppppppp/8/5r2/8/8/PPPPP1PP/RNBQK2R w KQkq - 0 1");
+    EXPECT_FALSE(MoveValidator::canCastleKingside(0, engine));
+    EXPECT_FALSE(MoveValidator::isValidMove(Move("e1g1"), 0, engine));
+}
+
+// test that unmaking every legal move restores the position, including castling, en passant and promotions
+TEST(MoveExecutorTest, UnmakeRestoresPosition) {
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"
+    };
+
+    for (const char* fen : fens) {
+        ChessEngine engine;
+        int player = engine.loadFEN(fen);
+        ChessEngine original = engine;
+
+        MoveList moves;
+        MoveGenerator::generateAllValidMoves(engine, player, moves);
+        for (PackedMove move : moves) {
+            UndoRecord undo;
+            MoveExecutor::makeMove(engine, move, player, undo);
+            MoveExecutor::unmakeMove(engine, undo, player);
+
+            for (int square = 0; square < 64; ++square) {
+                EXPECT_EQ(engine.pieceAt(square), original.pieceAt(square));
+            }
+            for (int piece = 0; piece < 12; ++piece) {
+                EXPECT_EQ(engine.pieces(piece / 6, piece % 6), original.pieces(piece / 6, piece % 6));
+            }
+            EXPECT_EQ(engine.playerPieces(0), original.playerPieces(0));
+            EXPECT_EQ(engine.playerPieces(1), original.playerPieces(1));
+            EXPECT_EQ(engine.allPieces(), original.allPieces());
+            EXPECT_EQ(engine.getHash(), original.getHash());
+
+            // the castling flags and the en passant target show up in the legal moves
+            MoveList after;
+            MoveGenerator::generateAllValidMoves(engine, player, after);
+            ASSERT_EQ(after.size(), moves.size());
+        }
+    }
+}
+
+// test that a move from an empty square or of the opponent's piece is refused without touching the undo record
+TEST(MoveExecutorTest, RefusesMoveOfOtherPiece) {
+    ChessEngine engine;
+    engine.newGame();
+    ChessEngine original = engine;
+
+    UndoRecord undo;
+    undo.hash = 42;
+    EXPECT_FALSE(MoveExecutor::makeMove(engine, Move("e4e5").toPacked(), 0, undo));
+    EXPECT_FALSE(MoveExecutor::makeMove(engine, Move("e7e5").toPacked(), 0, undo));
+    EXPECT_EQ(undo.hash, 42u);
+    for (int square = 0; square < 64; ++square) {
+        EXPECT_EQ(engine.pieceAt(square), original.pieceAt(square));
+    }
+    EXPECT_EQ(engine.getHash(), original.getHash());
+
+    EXPECT_TRUE(MoveExecutor::makeMove(engine, Move("e2e4").toPacked(), 0, undo));
+    EXPECT_EQ(undo.hash, original.getHash());
+}
+
+// test that the incrementally updated hash depends on the position, not on the move order
+TEST(MoveExecutorTest, HashTranspositions) {
+    ChessEngine engine;
+    engine.newGame();
+    engine.makeMove(Move("g1f3"), 0);
+    engine.makeMove(Move("g8f6"), 1);
+    engine.makeMove(Move("b1c3"), 0);
+    uint64_t hash = engine.getHash();
+
+    engine.newGame();
+    engine.makeMove(Move("b1c3"), 0);
+    engine.makeMove(Move("g8f6"), 1);
+    engine.makeMove(Move("g1f3"), 0);
+    EXPECT_EQ(engine.getHash(), hash);
+
+    // the same placement with the other side to move hashes differently
+    engine.loadFEN("r1bqkb1r/pppppppp/2n2n2/8/8/2N2N2/PPPPPPPP/R1BQKB1R b KQkq - 0 1");
+    uint64_t blackToMove = engine.getHash();
+    engine.loadFEN("r1bqkb1r/pppppppp/2n2n2/8/8/2N2N2/PPPPPPPP/R1BQKB1R w KQkq - 0 1");
+    EXPECT_NE(engine.getHash(), blackToMove);
+}
+
+// test that a null move hands the turn over, clearing the en passant target, and is taken back
+TEST(MoveExecutorTest, NullMove) {
+    ChessEngine engine;
+    int player = engine.loadFEN("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+    uint64_t hash = engine.getHash();
+
+    UndoRecord undo;
+    MoveExecutor::makeNullMove(engine, player, undo);
+    ChessEngine passed;
+    passed.loadFEN("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 3");
+    EXPECT_EQ(engine.getHash(), passed.getHash());
+    EXPECT_EQ(engine.getEnPassantTarget(), -1);
+
+    MoveExecutor::unmakeNullMove(engine, undo, player);
+    EXPECT_EQ(engine.getHash(), hash);
+    EXPECT_EQ(engine.getEnPassantTarget(), 45);
+}
+
+// test that the incrementally updated hash matches a full rehash along seeded random games, made and unmade
+TEST(MoveExecutorTest, RandomPlayoutsKeepHash) {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+    };
+    std::mt19937 random(2024);
+
+    for (const char* fen : fens) {
+        for (int game = 0; game < 8; ++game) {
+            ChessEngine engine;
+            int player = engine.loadFEN(fen);
+            uint64_t start = engine.getHash();
+
+            std::vector<UndoRecord> undos;
+            std::vector<bool> nullMoves;
+            for (int ply = 0; ply < 200; ++ply) {
+                MoveList moves;
+                MoveGenerator::generateAllValidMoves(engine, player, moves);
+                if (moves.empty()) {
+                    break;
+                }
+
+                // pass now and then, as the null-move search does
+                UndoRecord undo;
+                bool isNull = random() % 16 == 0;
+                if (isNull) {
+                    MoveExecutor::makeNullMove(engine, player, undo);
+                } else {
+                    PackedMove move = moves[random() % moves.size()];
+                    ASSERT_TRUE(MoveExecutor::makeMove(engine, move, player, undo));
+                }
+                undos.push_back(undo);
+                nullMoves.push_back(isNull);
+                player = 1 - player;
+                ASSERT_EQ(engine.getHash(), engine.calculateZobristHash());
+            }
+
+            while (!undos.empty()) {
+                player = 1 - player;
+                if (nullMoves.back()) {
+                    MoveExecutor::unmakeNullMove(engine, undos.back(), player);
+                } else {
+                    MoveExecutor::unmakeMove(engine, undos.back(), player);
+                }
+                undos.pop_back();
+                nullMoves.pop_back();
+                ASSERT_EQ(engine.getHash(), engine.calculateZobristHash());
+            }
+            EXPECT_EQ(engine.getHash(), start);
+        }
+    }
+}
+
+// test that the incrementally kept evaluation matches a rescan of the board after every move and its unmaking
+TEST(EvaluationTest, IncrementalMatchesRescan) {
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"
+    };
+
+    for (const char* fen : fens) {
+        ChessEngine engine;
+        int player = engine.loadFEN(fen);
+        int before = Evaluation::evaluate(engine, 0);
+
+        MoveList moves;
+        MoveGenerator::generateAllValidMoves(engine, player, moves);
+        for (PackedMove move : moves) {
+            UndoRecord undo;
+            MoveExecutor::makeMove(engine, move, player, undo);
+            int middlegame, endgame, phase;
+            Evaluation::computeScores(engine, middlegame, endgame, phase);
+            EXPECT_EQ(Evaluation::evaluate(engine, 0), Evaluation::taper(middlegame, endgame, phase));
+            EXPECT_EQ(Evaluation::evaluate(engine, 1), -Evaluation::evaluate(engine, 0));
+            MoveExecutor::unmakeMove(engine, undo, player);
+            EXPECT_EQ(Evaluation::evaluate(engine, 0), before);
+        }
+    }
+
+    // the starting position is symmetric, and a developed knight beats one on the rim
+    ChessEngine engine;
+    engine.newGame();
+    EXPECT_EQ(Evaluation::evaluate(engine, 0), 0);
+    EXPECT_GT(Evaluation::middlegame(KNIGHT, 21), Evaluation::middlegame(KNIGHT, 23));
+    EXPECT_EQ(Evaluation::middlegame(6 + KNIGHT, 42), -Evaluation::middlegame(KNIGHT, 18));
+}
+
+// test that the Zobrist keys are fixed at compile time and shared by every engine
+TEST(ZobristTest, KeysAreDeterministic) {
+    static_assert(Zobrist::piece(0, 0) != Zobrist::piece(0, 1), "piece keys must differ");
+    static_assert(Zobrist::side() != 0, "the side key must not be zero");
+
+    ChessEngine first;
+    ChessEngine second;
+    first.makeMove(Move("e2e4"), 0);
+    second.makeMove(Move("e2e4"), 0);
+    EXPECT_EQ(first.getHash(), second.getHash());
+
+    // the starting position hashes to the same value in every run
+    ChessEngine engine;
+    EXPECT_EQ(engine.getHash(), 0x78EF4D039BD78257ULL);
+}
+
+// test that the mailbox and the named accessors agree with the piece bitboards
+TEST(ChessEngineTest, MailboxMatchesBitboards) {
+    ChessEngine engine;
+    engine.newGame();
+    EXPECT_EQ(engine.pieceAt(4), KING);
+    EXPECT_EQ(engine.pieceAt(59), 6 + QUEEN);
+    EXPECT_EQ(engine.pieceAt(28), -1);
+    EXPECT_EQ(engine.whiteKnights(), engine.pieces(0, KNIGHT));
+
+    engine.makeMove(Move("e2e4"), 0);
+    EXPECT_EQ(engine.pieceAt(12), -1);
+    EXPECT_EQ(engine.pieceAt(28), PAWN);
+    for (int square = 0; square < 64; ++square) {
+        int piece = engine.pieceAt(square);
+        uint64_t bit = 1ULL << square;
+        EXPECT_EQ(piece == -1, !(engine.allPieces() & bit));
+        if (piece != -1) {
+            EXPECT_TRUE(engine.pieces(piece / 6, piece % 6) & bit);
+            EXPECT_TRUE(engine.playerPieces(piece / 6) & bit);
+        }
+    }
+}
+
+// test that a headless engine reports through the event sink and writes nothing to the console
+TEST(ChessEngineTest, HeadlessReportsEvents) {
+    ChessEngine engine;
+    engine.setHeadless(true);
+
+    std::vector<EngineEvent> events;
+    engine.setEventSink([&events](EngineEvent event, PackedMove, int) { events.push_back(event); });
+
+    testing::internal::CaptureStdout();
+    engine.makeMove(Move("e2e4"), 0);
+    EXPECT_FALSE(MoveValidator::isValidMove(Move("e3e4"), 1, engine));
+    std::string output = testing::internal::GetCapturedStdout();
+
+    EXPECT_TRUE(output.empty());
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0], EngineEvent::MOVE_MADE);
+    EXPECT_EQ(events[1], EngineEvent::NO_PIECE_TO_MOVE);
+}
+
+// test storing, probing and replacing transposition table entries
+TEST(TranspositionTableTest, StoreAndProbe) {
+    TranspositionTable table(1);
+    EXPECT_EQ(table.size(), 1024u * 1024 / 16);
+
+    TableEntry entry;
+    EXPECT_FALSE(table.probe(0x1234, entry));
+
+    table.newSearch();
+    table.store(0x1234, PackedMove(12, 28), -57, 6, Bound::LOWER);
+    ASSERT_TRUE(table.probe(0x1234, entry));
+    EXPECT_EQ(entry.move, PackedMove(12, 28));
+    EXPECT_EQ(entry.score, -57);
+    EXPECT_EQ(entry.depth, 6);
+    EXPECT_EQ(entry.bound, Bound::LOWER);
+
+    // a different key in the same bucket misses
+    EXPECT_FALSE(table.probe(0x1234 + (1ULL << 40), entry));
+
+    // a much shallower bound from the same search keeps the deeper entry
+    table.store(0x1234, PackedMove(), 10, 1, Bound::UPPER);
+    ASSERT_TRUE(table.probe(0x1234, entry));
+    EXPECT_EQ(entry.depth, 6);
+
+    // an exact result replaces it and keeps the stored move when it has none
+    table.store(0x1234, PackedMove(), 10, 1, Bound::EXACT);
+    ASSERT_TRUE(table.probe(0x1234, entry));
+    EXPECT_EQ(entry.bound, Bound::EXACT);
+    EXPECT_EQ(entry.move, PackedMove(12, 28));
+
+    table.clear();
+    EXPECT_FALSE(table.probe(0x1234, entry));
+}
+
+// test that the move picker hands out the hash move, then captures by MVV-LVA, then killers, then history order
+TEST(MovePickerTest, OrdersMoves) {
+    ChessEngine engine;
+    engine.loadFEN("4k3/8/8/3q4/8/2N5/3R4/4K3 w - - 0 1");
+
+    MoveList moves;
+    MoveGenerator::generateAllValidMoves(engine, 0, moves);
+    int count = moves.size();
+
+    PackedMove killers[2] = {PackedMove(11, 27), PackedMove()};
+    int history[64][64] = {};
+    MovePicker::updateHistory(history, PackedMove(18, 1), 4);
+
+    MovePicker picker(engine, moves, PackedMove(4, 5), killers, history);
+    std::vector<PackedMove> order;
+    PackedMove move;
+    while (picker.next(move)) {
+        order.push_back(move);
+    }
+
+    ASSERT_EQ(static_cast<int>(order.size()), count);
+    EXPECT_EQ(order[0], PackedMove(4, 5));    // hash move e1f1
+    EXPECT_EQ(order[1], PackedMove(18, 35));  // the knight takes the queen before the rook does
+    EXPECT_EQ(order[2], PackedMove(11, 35));
+    EXPECT_EQ(order[3], PackedMove(11, 27));  // killer d2d4
+    EXPECT_EQ(order[4], PackedMove(18, 1));   // best history score, c3b1
+    EXPECT_TRUE(MovePicker::isQuiet(engine, order[4]));
+    EXPECT_TRUE(MovePicker::isCapture(engine, order[1]));
+}
+
+// test the capture-only generator against the captures in the full move list
+TEST(MoveGeneratorTest, CapturesOnly) {
+    ChessEngine engine;
+    engine.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    MoveList captures;
+    MoveGenerator::generateCaptures(engine, 0, captures);
+    EXPECT_EQ(captures.size(), 8);
+    for (PackedMove move : captures) {
+        EXPECT_TRUE(MovePicker::isCapture(engine, move));
+    }
+
+    // a promotion push is included as a queen promotion only
+    engine.loadFEN("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+    captures.clear();
+    MoveGenerator::generateCaptures(engine, 0, captures);
+    ASSERT_EQ(captures.size(), 1);
+    EXPECT_EQ(captures[0], PackedMove(49, 57, PackedMove::PROMOTE_QUEEN));
+}